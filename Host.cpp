@@ -4,7 +4,6 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
-#include <cuda_runtime.h>
 #include "./data_utilities/StatStructs.h"
 #include <limits>
 #include <future>
@@ -16,14 +15,16 @@
 #include <map>
 #include <cmath>
 #include <tuple>
-#include "./hyperblock_generation/MergerHyperBlock.cuh"
 #include "./hyperblock/HyperBlock.h"
+#include "./hyperblock/BlockBoxes.h"
 #include "./interval_hyperblock/IntervalHyperBlock.h"
 #include "./knn/Knn.h"
 #include "./screen_output/PrintingUtil.h"
 #include "./data_utilities/DataUtil.h"
 #include "./simplifications/Simplifications.h"
 #include "classification_testing/ClassificationTests.h"
+#include "classification_testing/OneToOneModel.h"
+#include "inference_server/InferenceServer.h"
 using namespace std;
 
 #ifdef _WIN32
@@ -150,18 +151,18 @@ vector<vector<HyperBlock>> oneToOneHyper(const vector<vector<vector<float>>>& tr
     return oneToOneHyperBlocks;
 }
 
-float testAccuracyOfHyperBlocks(vector<HyperBlock> &hyperBlocks, vector<vector<vector<float>>> &testData, vector<vector<vector<float>>> &trainingData, map<pair<int, int>, PointSummary>& pointSummaries, int k = 5, float threshold = 0.25) {
+float testAccuracyOfHyperBlocks(vector<HyperBlock> &hyperBlocks, vector<vector<vector<float>>> &testData, vector<vector<vector<float>>> &trainingData, PointSummaries& pointSummaries, int k = 5, float threshold = 0.25) {
 
     // get our confusion matrix by just classifying with the blocks like normal
-    vector<vector<vector<float>>> notClassifiedPoints(NUM_CLASSES);
+    vector<vector<int>> notClassifiedPoints(NUM_CLASSES);
     vector<vector<long>> hyperBlocksConfusionMatrix = ClassificationTests::buildConfusionMatrix(hyperBlocks, trainingData, testData, ClassificationTests::HYPERBLOCKS, notClassifiedPoints, NUM_CLASSES, pointSummaries);
 
     cout << "------------------------HYPERBLOCKS CONFUSION MATRIX-----------------------------" << endl;
     float hbAccuracy = PrintingUtil::printConfusionMatrix(hyperBlocksConfusionMatrix, NUM_CLASSES, CLASS_MAP_INT);
 
     // now build our second confusion matrix out of the unclassified stuff only
-    vector<vector<vector<float>>> stillNotClassifiedPoints(NUM_CLASSES);
-    vector<vector<long>> knnMatrix = ClassificationTests::buildConfusionMatrix(hyperBlocks, trainingData, notClassifiedPoints, ClassificationTests::PURE_KNN, stillNotClassifiedPoints, NUM_CLASSES, pointSummaries, k, threshold);
+    vector<vector<int>> stillNotClassifiedPoints(NUM_CLASSES);
+    vector<vector<long>> knnMatrix = ClassificationTests::buildConfusionMatrix(hyperBlocks, trainingData, testData, ClassificationTests::PURE_KNN, stillNotClassifiedPoints, NUM_CLASSES, pointSummaries, k, threshold, &notClassifiedPoints);
 
     cout << "------------------------KNN CONFUSION MATRIX--------------------------------" << endl;
     float knnAccuracy = PrintingUtil::printConfusionMatrix(knnMatrix, NUM_CLASSES, CLASS_MAP_INT);
@@ -291,7 +292,7 @@ tuple<int,float,float> findBestParameters(vector<vector<vector<float>>> &dataset
         for (size_t kI=0;kI<kVals.size();++kI)
             for (size_t tI=0;tI<tVals.size();++tI) {
                 Knn::deviationsComputed = false;            // reset per fold
-                map<pair<int,int>,PointSummary> summaries;
+                PointSummaries summaries;
                 float foldAcc = testAccuracyOfHyperBlocks(hbs, test, train, summaries, kVals[kI], tVals[tI]);
                 acc[kI][tI] += foldAcc;
             }
@@ -419,7 +420,7 @@ vector<float> runKFold(vector<vector<vector<float>>> &dataset, vector<pair<int,i
             }
 
             // get our accuracy now for this fold.
-            map<pair<int, int>, PointSummary> pointSummaries;
+            PointSummaries pointSummaries;
             acc += testAccuracyOfHyperBlocks(hyperBlocks, testData, trainingData,pointSummaries, nearestNeighborK, similarityThreshold);
             blockCount += hyperBlocks.size();
             cCount += clauseCount;
@@ -560,7 +561,7 @@ vector<float> runKFoldWithLevelNBlocks(vector<vector<vector<float>>> &dataset, b
         }
 
         // get our accuracy now for this fold.
-        map<pair<int, int>, PointSummary> pointSummaries;
+        PointSummaries pointSummaries;
         acc += testAccuracyOfHyperBlocks(hyperBlocks, testData, trainingData,pointSummaries, nearestNeighborK, similarityThreshold);
         blockCount += hyperBlocks.size();
         cCount += clauseCount;
@@ -588,6 +589,14 @@ float evaluateOneToSomeHBs(const vector<vector<HyperBlock>>& oneToSomeBlocks, co
         totalPoints += c.size();
     }
 
+    // boxes for every sieve level, built once instead of going through every block for every point.
+    vector<BlockBoxes> levelBoxes;
+    for (const auto& levelBlocks : oneToSomeBlocks)
+        levelBoxes.emplace_back(levelBlocks, FIELD_LENGTH);
+    vector<BlockBoxes::Scratch> levelScratch;
+    for (const auto& boxes : levelBoxes)
+        levelScratch.emplace_back(boxes);
+
     int incorrect = 0;
     int correct = 0;
     int pointsTested = 0;
@@ -596,26 +605,24 @@ float evaluateOneToSomeHBs(const vector<vector<HyperBlock>>& oneToSomeBlocks, co
         for(int j = 0; j < testData[i].size(); j++) {
             pointsTested++;
             const auto& point = testData[i][j];
-            bool classified = false;
 
             for(int sieveLvl = 0; sieveLvl < oneToSomeBlocks.size(); sieveLvl++) {
-                for(const auto& hb : oneToSomeBlocks[sieveLvl]) {
-                    if(hb.inside_HB(point.size(), point.data())) {
-                        classified = true;
-
-                        // If it is of the wrong class.
-                        if(hb.classNum != i) {
-                            incorrect++;
-                        }
-                        else {
-                            correct++;
-                        }
-
-                        confusionMatrix[i][hb.classNum]++;
-                        break;
-                    }
+                // the first block of the level it falls in, same one the old loop stopped at.
+                const int b = levelBoxes[sieveLvl].firstContaining(point.data(), levelScratch[sieveLvl]);
+                if (b == -1)
+                    continue;
+
+                const auto& hb = oneToSomeBlocks[sieveLvl][b];
+                // If it is of the wrong class.
+                if(hb.classNum != i) {
+                    incorrect++;
                 }
-                if (classified) break; // do not keep checking once classified
+                else {
+                    correct++;
+                }
+
+                confusionMatrix[i][hb.classNum]++;
+                break; // do not keep checking once classified
             }
         }
     }
@@ -732,45 +739,18 @@ void evaluateOneToOneHyperBlocks(
     vector<int> correctPerClass(numClasses, 0);
     vector<int> totalPerClass(numClasses, 0);
 
+    // the pairs get looked up once and every block tested once, instead of searching classPairs and testing every block twice for every point.
+    const OneToOneModel model(oneToOneHBs, classPairs, FIELD_LENGTH, numClasses);
+    for (const auto& missing : model.missingPairs())
+        cerr << "Error: could not find block set for classes " << missing.first << " and " << missing.second << "\n";
 
+    vector<int> predictions;
     for (int actualClass = 0; actualClass < numClasses; ++actualClass) {
-        for (const auto& point : testSet[actualClass]) {
-            vector<int> votes(numClasses, 0);
-
-            // Run all pairwise comparisons
-            for (int i = 0; i < numClasses; ++i) {
-                for (int j = i + 1; j < numClasses; ++j) {
-                    // Find the correct index using classPairs
-                    int findPairIndex = -1;
-                    for (int idx = 0; idx < classPairs.size(); ++idx) {
-                        if ((classPairs[idx].first == i && classPairs[idx].second == j) ||
-                            (classPairs[idx].first == j && classPairs[idx].second == i)) {
-                            findPairIndex = idx;
-                            break;
-                            }
-                    }
-                    if (findPairIndex == -1) {
-                        cerr << "Error: could not find block set for classes " << i << " and " << j << "\n";
-                        continue;
-                    }
-
-                    const auto& pairHBs = oneToOneHBs[findPairIndex];
-
+        // majority vote of all the pairs, the points split across the threads
+        model.predictBatch(testSet[actualClass], predictions);
 
-                    for (const auto& block : pairHBs) {
-                        if (block.classNum == i && block.inside_HB(point.size(), point.data())) {
-                            votes[i]++;
-                        }
-                        if (block.classNum == j && block.inside_HB(point.size(), point.data())) {
-                            votes[j]++;
-                        }
-                    }
-                }
-            }
-
-            // Majority vote
-            int predictedClass = distance(votes.begin(), max_element(votes.begin(), votes.end()));
-            if (votes[predictedClass] == 0) {
+        for (const int predictedClass : predictions) {
+            if (predictedClass == -1) {
                 // No vote: optionally handle as unclassified
                 continue;
             }
@@ -836,7 +816,7 @@ float genAndRunPrecisionWeightedHBs(vector<vector<vector<float>>>& trainingData,
                                     vector<vector<int>> bestVectorsIndexes
 ) {
 
-    map<pair<int, int>, PointSummary> pointSummaries;
+    PointSummaries pointSummaries;
 
     //TODO: We need to set up a temp so that the training data is reset to its entire version after running this program.
     vector<vector<vector<float>>> validationData;
@@ -847,7 +827,7 @@ float genAndRunPrecisionWeightedHBs(vector<vector<vector<float>>>& trainingData,
     Simplifications::runSimplifications(hyperBlocks, trainingData, bestVectorsIndexes);
 
     // Test the validation HBS, returns confusion matrix, vector<vector<long>>
-    vector<vector<vector<float>>> stillUnclassified(NUM_CLASSES);
+    vector<vector<int>> stillUnclassified(NUM_CLASSES);
     vector<vector<long>> confusionMatrix = ClassificationTests::buildConfusionMatrix(hyperBlocks, trainingData, validationData, ClassificationTests::HYPERBLOCKS,stillUnclassified , NUM_CLASSES, pointSummaries);
 
     for(auto& hb : hyperBlocks) {
@@ -857,24 +837,24 @@ float genAndRunPrecisionWeightedHBs(vector<vector<vector<float>>>& trainingData,
     // Go through and make a non-distinct confusion matrix.
     std::vector<std::vector<long>> ultraConfusionMatrix(NUM_CLASSES, std::vector<long>(NUM_CLASSES, 0));
 
-    for (const auto& entry : pointSummaries) {
-        const PointSummary& summary = entry.second;
-        int trueClass = summary.classIdx;
+    for (int n = 0; n < pointSummaries.numPoints(); n++) {
+        if (pointSummaries.predicted[n] == -1)
+            continue;
+        int trueClass = pointSummaries.classOf(n);
 
-        for (const BlockInfo& hit : summary.blockHits) {
-            int blockClass = hit.blockClass;
+        for (const BlockInfo* hit = pointSummaries.hitsBegin(n); hit != pointSummaries.hitsEnd(n); ++hit) {
+            int blockClass = hit->blockClass;
             ultraConfusionMatrix[trueClass][blockClass] += 1;
         }
     }
 
 
-    pointSummaries.clear();
     vector<vector<long>> newConfusion = ClassificationTests::buildConfusionMatrix(hyperBlocks, trainingData, testingData, ClassificationTests::PRECISION_WEIGHTED, stillUnclassified , NUM_CLASSES, pointSummaries);
     cout << "\nPrecision Weighted Matrix " << endl;
     PrintingUtil::printConfusionMatrix(newConfusion, NUM_CLASSES, CLASS_MAP_INT);
 
-    vector<vector<vector<float>>> unclassed(NUM_CLASSES);
-    vector<vector<long>> knnMatrix = ClassificationTests::buildConfusionMatrix(hyperBlocks, trainingData, stillUnclassified, ClassificationTests::PURE_KNN, unclassed , NUM_CLASSES, pointSummaries);
+    vector<vector<int>> unclassed(NUM_CLASSES);
+    vector<vector<long>> knnMatrix = ClassificationTests::buildConfusionMatrix(hyperBlocks, trainingData, testingData, ClassificationTests::PURE_KNN, unclassed , NUM_CLASSES, pointSummaries, 5, 0.25, &stillUnclassified);
     cout << "\nKNN matrix" << endl;
     PrintingUtil::printConfusionMatrix(knnMatrix, NUM_CLASSES, CLASS_MAP_INT);
 
@@ -1096,9 +1076,7 @@ void runInteractive() {
 
                 cout << "HyperBlocks imported from file " << hyperBlocksImportFileName << " successfully" << endl;
 
-                for(HyperBlock& hb: hyperBlocks){
-                  hb.find_avg_and_size(trainingData);
-                }
+                HyperBlock::find_avg_and_size_all(hyperBlocks, trainingData);
 
                 PrintingUtil::waitForEnter();
                 break;
@@ -1153,7 +1131,7 @@ void runInteractive() {
             }
             case 8: { // TEST HBs ON CURRENT TESTING DATASET
                 cout << "Testing HBs on testing dataset" << endl;
-                map<pair<int, int>, PointSummary> pointSummaries;
+                PointSummaries pointSummaries;
                 testAccuracyOfHyperBlocks(hyperBlocks, testData, trainingData, pointSummaries);
                 PrintingUtil::waitForEnter();
                 break;
@@ -1309,6 +1287,27 @@ void runInteractive() {
                 running = false;
                 break;
             }
+            case 21: {      // SIMPLIFY HYPERBLOCKS, SEARCHING REMOVAL ORDERS
+                // same as 7, but every block tries several attribute removal orders and keeps whichever takes out the most clauses.
+                auto start = chrono::high_resolution_clock::now();
+                Simplifications::removeUselessAttrNoDisjunction(hyperBlocks, trainingData, bestVectorsIndexes, true);
+                auto end = chrono::high_resolution_clock::now();
+                chrono::duration<double> diff = end - start;
+                cout << "Time taken: " << diff.count() << " seconds" << endl;
+
+                int newClauseCount = 0;
+                for (const auto &hb : hyperBlocks) {
+                    for (int a = 0; a < FIELD_LENGTH; a++) {
+                        if (hb.minimums[a][0] != 0.0f || hb.maximums[a][0] != 1.0f)
+                            newClauseCount++;
+                    }
+                }
+
+                cout << "New clause count: " << newClauseCount << endl;
+                cout << "We got a final total of: " << hyperBlocks.size() << " blocks." << endl;
+                PrintingUtil::waitForEnter();
+                break;
+            }
             default: {
                 cout << "\nInvalid choice. Please try again." << endl;
                 PrintingUtil::waitForEnter();
@@ -1322,6 +1321,10 @@ void runInteractive() {
 // Main entry point: choose mode based on argc.
 int main(int argc, char* argv[]) {
 
+    // Server mode, load a saved model and classify points as they come in
+    if (argc >= 2 && string(argv[1]) == "--serve")
+        return InferenceServer::run(argc, argv);
+
     // Command line input mode, allows you to specify in command line what to do
     if (argc >= 2)
         return runAsync(argc, argv);
@@ -3,46 +3,114 @@
 //
 
 #include "ClassificationTests.h"
+#include <numeric>
+#include <omp.h>
 
 
 /*
  * takes in our hyperblocks by reference. takes in the points we need to classify. and takes in a mode, as well as a reference to another container for points.
  * the points we can't classify is for those which fall out of all HBs. this allows us to easily make a list of points we couldn't handle, and we would just call the function
- * again with another mode, to reclassify those points specifically.
+ * again with another mode and that list as pointsToDo, to reclassify those points specifically. the list is indices into testingData[class], not copies of the points.
+ *
+ * the points get split across the OpenMP threads, each one keeps its own confusion matrix and they get added up at the end.
+ * pointSummaries starts over every call, and has every point of testingData in it, the ones we didn't do just have no prediction.
  */
-vector<vector<long>> ClassificationTests::buildConfusionMatrix(vector<HyperBlock> &hyperBlocks, const vector<vector<vector<float>>> &trainingData, vector<vector<vector<float>>> &testingData, int classificationMode, vector<vector<vector<float>>> &pointsWeCantClassify, const int NUM_CLASSES, map<pair<int, int>, PointSummary>& pointSummaries,int k, float threshold) {
+vector<vector<long>> ClassificationTests::buildConfusionMatrix(vector<HyperBlock> &hyperBlocks, const vector<vector<vector<float>>> &trainingData, vector<vector<vector<float>>> &testingData, int classificationMode, vector<vector<int>> &pointsWeCantClassify, const int NUM_CLASSES, PointSummaries& pointSummaries, int k, float threshold, const vector<vector<int>> *pointsToDo) {
 
     vector<vector<long>> confusionMatrix(NUM_CLASSES, vector<long>(NUM_CLASSES, 0));
 
-    int totalPointsToDo = 0;
-    for (const auto &classPoints : testingData) {
-        totalPointsToDo += classPoints.size();
+    switch (classificationMode) {
+        case HYPERBLOCKS:
+        case PURE_KNN:
+        case CLOSEST_BLOCK:
+        case BRUTE_MERGABLE:
+        case THRESHOLD_KNN:
+        case OLD_KNN:
+        case MERGABLE_KNN:
+        case PRECISION_WEIGHTED:
+            break;
+        // has to be caught out here, we can't throw out of the parallel loop.
+        default:
+            throw new runtime_error("Unknown classification mode");
     }
 
-    if (totalPointsToDo == 0)
-        return confusionMatrix;
+    // number every point, class after class, and start the summaries over.
+    pointSummaries.classStart.assign(NUM_CLASSES + 1, 0);
+    for (int cls = 0; cls < NUM_CLASSES; cls++)
+        pointSummaries.classStart[cls + 1] = pointSummaries.classStart[cls] + testingData[cls].size();
+    const int numPoints = pointSummaries.classStart.back();
+    pointSummaries.predicted.assign(numPoints, -1);
+    pointSummaries.hitStart.assign(numPoints + 1, 0);
+    pointSummaries.hits.clear();
+    pointsWeCantClassify.assign(NUM_CLASSES, vector<int>());
+
+    // every point, unless we got handed which ones to do.
+    vector<int> todo;
+    if (pointsToDo) {
+        for (int cls = 0; cls < NUM_CLASSES; cls++)
+            for (const int point : (*pointsToDo)[cls])
+                todo.push_back(pointSummaries.pointNumber(cls, point));
+    }
+    else {
+        todo.resize(numPoints);
+        iota(todo.begin(), todo.end(), 0);
+    }
 
-    // go through all classes
-    for(int cls = 0; cls < NUM_CLASSES; cls++) {
+    if (todo.empty())
+        return confusionMatrix;
 
-        // all points each class. we are going to use whichever classifier we have called our function with to build the matrix
-        for(int point = 0; point < testingData[cls].size(); point++) {
+    int numAttributes = 0;
+    for (const auto &classPoints : testingData)
+        if (!classPoints.empty())
+            numAttributes = classPoints[0].size();
+
+    // HB voting goes through the compiled blocks, built once here so the class counts and the vote of every block aren't redone for every point.
+    HyperBlockModel model;
+    if (classificationMode == HYPERBLOCKS || classificationMode == PRECISION_WEIGHTED)
+        model = HyperBlockModel(hyperBlocks, numAttributes, NUM_CLASSES, classificationMode == PRECISION_WEIGHTED);
+
+    // the KNNs with shared setup get it done here, so the threads only read it.
+    AttributeColumns mergableColumns;
+    if (classificationMode == MERGABLE_KNN)
+        mergableColumns = Knn::setupMergable(trainingData, hyperBlocks, numAttributes);
+    if (classificationMode == THRESHOLD_KNN)
+        Knn::setupDeviations(trainingData);
+    vector<pair<float, float>> bruteImpurityRange;
+    if (classificationMode == BRUTE_MERGABLE)
+        bruteImpurityRange = Knn::setupBruteMergable(trainingData, hyperBlocks, NUM_CLASSES);
+
+    // every thread puts its hits in its own buffer. we remember where each point's went, and put the shared buffer together in point order after.
+    vector<vector<BlockInfo>> threadHits(omp_get_max_threads());
+    vector<int> hitThread(numPoints, 0);
+    vector<int> hitOffset(numPoints, 0);
+
+    #pragma omp parallel
+    {
+        const int thread = omp_get_thread_num();
+        vector<BlockInfo> &localHits = threadHits[thread];
+        vector<vector<long>> localConfusion(NUM_CLASSES, vector<long>(NUM_CLASSES, 0));
+
+        HyperBlockModel::Scratch modelScratch;
+        if (classificationMode == HYPERBLOCKS || classificationMode == PRECISION_WEIGHTED)
+            modelScratch = HyperBlockModel::Scratch(model);
+
+        #pragma omp for schedule(dynamic, 16)
+        for (int i = 0; i < (int)todo.size(); i++) {
 
             // get our reference to the point
-            const auto &p = testingData[cls][point];
+            const int n = todo[i];
+            const int cls = pointSummaries.classOf(n);
+            const auto &p = testingData[cls][n - pointSummaries.classStart[cls]];
+            const int firstHit = localHits.size();
             int predictedClass = -1;
-            vector<BlockInfo> blockHits{};
-            pair<int, vector<BlockInfo>> prediction;
 
             // call whichever classifier we are using now.
             switch (classificationMode) {
 
                 // regular old HBs case. this is the original case, where we just take the classification of whichever block it falls in.
                 case HYPERBLOCKS:
-                    // call the function which predicts one point
-                    prediction = predictWithHBs(hyperBlocks, p, NUM_CLASSES, pointSummaries);
-                    predictedClass = prediction.first;
-                    blockHits = prediction.second;
+                    // every block it's in votes 1 / blocks of its class, a tie is -1.
+                    predictedClass = model.predict(p.data(), modelScratch, &localHits);
                     break;
 
                 case PURE_KNN:
@@ -54,7 +122,7 @@ vector<vector<long>> ClassificationTests::buildConfusionMatrix(vector<HyperBlock
                     break;
 
                 case BRUTE_MERGABLE:
-                    predictedClass = Knn::bruteMergable(p, trainingData, hyperBlocks, k, NUM_CLASSES);
+                    predictedClass = Knn::bruteMergable(p, trainingData, hyperBlocks, bruteImpurityRange, NUM_CLASSES);
                     break;
 
                 // our explainable distance based KNN. takes a similarity of our point, then all train data, and uses k nearest to vote
@@ -69,38 +137,58 @@ vector<vector<long>> ClassificationTests::buildConfusionMatrix(vector<HyperBlock
                     break;
 
                 case MERGABLE_KNN:
-                    predictedClass = Knn::mergableKNN(p, trainingData, hyperBlocks, NUM_CLASSES);
+                    predictedClass = Knn::mergableKNN(p, mergableColumns, hyperBlocks);
                     break;
 
                 case PRECISION_WEIGHTED:
-                    prediction = precisionWeightedHBs(p, testingData, hyperBlocks, NUM_CLASSES, pointSummaries);
-                    predictedClass = prediction.first;
-                    blockHits = prediction.second;
+                    // every block it's in votes with its precisions (setHBPrecisions), the first class with the most wins.
+                    predictedClass = model.predict(p.data(), modelScratch, &localHits);
                     break;
-                default:
-                    throw new runtime_error("Unknown classification mode");
             }
-            // if we didn't classify it, put it in the not classified points. should only happen when we use HB mode.
+
+            // if we didn't classify it, it goes in the not classified points after. should only happen when we use HB mode. those don't get a summary.
             if (predictedClass == -1) {
-                pointsWeCantClassify[cls].push_back(p);
-            }
-            else {
-                confusionMatrix[cls][predictedClass]++;
-                PointSummary& summary = pointSummaries[make_pair(cls, point)];
-                summary.classIdx = cls;
-                summary.pointIdx = point;
-                summary.predictedIdx = predictedClass;
-                summary.blockHits = blockHits;
+                localHits.resize(firstHit);
+                continue;
             }
+
+            localConfusion[cls][predictedClass]++;
+            pointSummaries.predicted[n] = predictedClass;
+            pointSummaries.hitStart[n + 1] = localHits.size() - firstHit;    // just the count for now
+            hitThread[n] = thread;
+            hitOffset[n] = firstHit;
+        }
+
+        #pragma omp critical
+        {
+            for (int actual = 0; actual < NUM_CLASSES; actual++)
+                for (int predicted = 0; predicted < NUM_CLASSES; predicted++)
+                    confusionMatrix[actual][predicted] += localConfusion[actual][predicted];
         }
     }
 
+    // the counts into starts, then every point's hits copied into place.
+    for (int n = 0; n < numPoints; n++)
+        pointSummaries.hitStart[n + 1] += pointSummaries.hitStart[n];
+    pointSummaries.hits.resize(pointSummaries.hitStart.back());
+    for (int n = 0; n < numPoints; n++) {
+        const int count = pointSummaries.hitStart[n + 1] - pointSummaries.hitStart[n];
+        const vector<BlockInfo> &from = threadHits[hitThread[n]];
+        copy(from.begin() + hitOffset[n], from.begin() + hitOffset[n] + count, pointSummaries.hits.begin() + pointSummaries.hitStart[n]);
+    }
+
+    for (const int n : todo)
+        if (pointSummaries.predicted[n] == -1)
+            pointsWeCantClassify[pointSummaries.classOf(n)].push_back(pointSummaries.pointIdxOf(n));
+
     // now we can just return our matrix
     return confusionMatrix;
 }
 
 
-pair<int, vector<BlockInfo>> ClassificationTests::precisionWeightedHBs(const vector<float> &point, vector<vector<vector<float>>>& testData, vector<HyperBlock>& hyperBlocks, int NUM_CLASSES, map<pair<int, int>, PointSummary>& pointSummaries) {
+// one point at a time through every block, the way PRECISION_WEIGHTED always worked. buildConfusionMatrix goes through HyperBlockModel instead,
+// this stays as the plain version to check the model's precision weighted votes against, same winner and same hits in the same order.
+pair<int, vector<BlockInfo>> ClassificationTests::precisionWeightedHBs(const vector<float> &point, const vector<HyperBlock>& hyperBlocks, int NUM_CLASSES) {
 
     // Precision lost will hold each class of HB precison lost stats for each individual class
     /// Ex cls 0:  [0, .04, .10] indicates the precision lost from 0 was none, 1 was 4% and 2 was 10%
@@ -115,22 +203,21 @@ pair<int, vector<BlockInfo>> ClassificationTests::precisionWeightedHBs(const vec
     vector<float> floatVote(NUM_CLASSES, 0.0f);
     vector<BlockInfo> blockHits;
 
-    for(int i = 0; i < hyperBlocks.size(); i++) {
-        const auto& hb = hyperBlocks[i];
-
+    for(const HyperBlock &hb : hyperBlocks) {
         // If the point is within the HB
-        if(hb.inside_HB(point.size(), point.data())) {
-            blockHits.push_back(BlockInfo{hb.classNum, hb.blockId, hb.size, -1});
-
-            // We vote for the right class using precision
-            if(totalHBsPerClass[hb.classNum] > 0) {
-                floatVote[hb.classNum] += (hb.blockPrecision / totalHBsPerClass[hb.classNum]);
-
-                // We vote for the possible other classes using the precision lost metric.
-                for(int conf = 0; conf < NUM_CLASSES; conf++) {
-                    // Vote for other classes is HB precision total * other class precision lost,
-                    floatVote[conf] += hb.precisionLostByClass[conf] / totalHBsPerClass[hb.classNum];
-                }
+        if(!hb.inside_HB(point.size(), point.data()))
+            continue;
+
+        blockHits.push_back(BlockInfo{hb.classNum, hb.blockId, hb.size, -1});
+
+        // We vote for the right class using precision
+        if(totalHBsPerClass[hb.classNum] > 0) {
+            floatVote[hb.classNum] += (hb.blockPrecision / totalHBsPerClass[hb.classNum]);
+
+            // We vote for the possible other classes using the precision lost metric.
+            for(int conf = 0; conf < NUM_CLASSES; conf++) {
+                // Vote for other classes is HB precision total * other class precision lost,
+                floatVote[conf] += hb.precisionLostByClass[conf] / totalHBsPerClass[hb.classNum];
             }
         }
     }
@@ -149,60 +236,5 @@ pair<int, vector<BlockInfo>> ClassificationTests::precisionWeightedHBs(const vec
         return {-1, blockHits};
     }
 
-
     return {winningClass, blockHits};
 }
-
-
-
-
-pair<int, vector<BlockInfo>> ClassificationTests::predictWithHBs(
-    const vector<HyperBlock> &hyperBlocks, const vector<float> &point,
-    int NUM_CLASSES, map<pair<int, int>, PointSummary>& pointSummaries) {
-
-    vector<int> numHbsPerClass(NUM_CLASSES, 0);
-    for (const auto &hb : hyperBlocks) {
-        numHbsPerClass[hb.classNum]++;
-    }
-
-    vector<float> votes(NUM_CLASSES, 0.0f);
-    vector<BlockInfo> blockHits;
-
-    for (int i = 0; i < hyperBlocks.size(); i++) {
-        const auto &block = hyperBlocks[i];
-        if (block.inside_HB(point.size(), point.data())) {
-            float weight = 1.0f / numHbsPerClass[block.classNum];
-            votes[block.classNum] += weight;
-            blockHits.push_back(BlockInfo{block.classNum, block.blockId, block.size, -1});
-        }
-    }
-
-    float maxVote = *max_element(votes.begin(), votes.end());
-
-    if (maxVote == 0.0f) {
-        return {-1, blockHits};
-    }
-
-    // Case 2: check for ties
-    int winner = -1;
-    int countMax = 0;
-    for (int cls = 0; cls < NUM_CLASSES; ++cls) {
-        if (votes[cls] == maxVote) {
-            ++countMax;
-            winner = cls;  // last one seen; we only care that there's >1
-        }
-    }
-
-    // if more than one class had that same amount of votes we return -1.
-    if (countMax > 1) {
-        // Tie between multiple classes
-        return {-1, blockHits};
-    }
-
-    // if we had a real winner we can return it.
-    return {winner, blockHits};
-}
-
-
-
-
@@ -15,6 +15,7 @@ using namespace std;
 #include "../data_utilities/StatStructs.h"
 
 #include "../hyperblock/HyperBlock.h"
+#include "HyperBlockModel.h"
 
 class ClassificationTests {
 public:
@@ -33,11 +34,9 @@ public:
     };
 
     // main function which takes in points we need to classify, and classifies them using whichever mode we are in.
-    static vector<vector<long>> buildConfusionMatrix(vector<HyperBlock> &hyperBlocks, const vector<vector<vector<float>>> &trainingData, vector<vector<vector<float>>> &pointsToClassify, int classificationMode, vector<vector<vector<float>>> &pointsWeCantClassify, const int NUM_CLASSES, map<pair<int, int>, PointSummary>& pointSummaries, int k = 5, float threshold = 0.25);
-    static pair<int, vector<BlockInfo>> precisionWeightedHBs(const vector<float> &point, vector<vector<vector<float>>>& testData, vector<HyperBlock>& hyperBlocks, int NUM_CLASSES, map<pair<int, int>, PointSummary>& pointSummaries);
-
-    static pair<int, vector<BlockInfo>> predictWithHBs(const vector<HyperBlock> &hyperBlocks, const vector<float> &point, int NUM_CLASSES, map<pair<int, int>, PointSummary>& pointSummaries);
-
+    static vector<vector<long>> buildConfusionMatrix(vector<HyperBlock> &hyperBlocks, const vector<vector<vector<float>>> &trainingData, vector<vector<vector<float>>> &pointsToClassify, int classificationMode, vector<vector<int>> &pointsWeCantClassify, const int NUM_CLASSES, PointSummaries& pointSummaries, int k = 5, float threshold = 0.25, const vector<vector<int>> *pointsToDo = nullptr);
+    // the per point precision weighted vote HyperBlockModel was built from, kept to check the model against. nothing in the menu calls it.
+    static pair<int, vector<BlockInfo>> precisionWeightedHBs(const vector<float> &point, const vector<HyperBlock>& hyperBlocks, int NUM_CLASSES);
 };
 
 
@@ -0,0 +1,126 @@
+#include "HyperBlockModel.h"
+#include <algorithm>
+#include <omp.h>
+
+HyperBlockModel::HyperBlockModel(const vector<HyperBlock> &hyperBlocks, int numAttributes, int numClasses, bool precisionWeighted) : numAttributes(numAttributes), numClasses(numClasses), precisionWeighted(precisionWeighted), boxes(hyperBlocks, numAttributes) {
+    const int blockCount = hyperBlocks.size();
+
+    vector<int> numHbsPerClass(numClasses, 0);
+    for (const auto &hb : hyperBlocks)
+        numHbsPerClass[hb.classNum]++;
+
+    blockClass.resize(blockCount);
+    blockWeight.resize(blockCount);
+    blockIds.resize(blockCount);
+    blockSizes.resize(blockCount);
+
+    for (int b = 0; b < blockCount; b++) {
+        const HyperBlock &hb = hyperBlocks[b];
+        blockClass[b] = hb.classNum;
+        blockWeight[b] = 1.0f / numHbsPerClass[hb.classNum];
+        blockIds[b] = hb.blockId;
+        blockSizes[b] = hb.size;
+    }
+
+    voteStride = numClasses;
+    if (!precisionWeighted)
+        return;
+
+    // a block's own class gets blockPrecision plus precisionLostByClass of its own class, which setHBPrecisions always leaves at 0.
+    // blocks without precisions yet lose nothing.
+    voteStride = (numClasses + BOX_LANES - 1) / BOX_LANES * BOX_LANES;
+    blockVotes.assign((size_t)blockCount * voteStride, 0.0f);
+    for (int b = 0; b < blockCount; b++) {
+        const HyperBlock &hb = hyperBlocks[b];
+        float *row = &blockVotes[(size_t)b * voteStride];
+        for (int cls = 0; cls < (int)hb.precisionLostByClass.size() && cls < numClasses; cls++)
+            row[cls] = hb.precisionLostByClass[cls] / numHbsPerClass[hb.classNum];
+        row[hb.classNum] = hb.blockPrecision / numHbsPerClass[hb.classNum] + row[hb.classNum];
+    }
+}
+
+int HyperBlockModel::predict(const float *point, Scratch &scratch, vector<BlockInfo> *hits) const {
+    vector<float> &votes = scratch.votes;
+    fill(votes.begin(), votes.end(), 0.0f);
+
+    if (precisionWeighted) {
+        float *sums = votes.data();
+        boxes.forEachContaining(point, scratch.boxes, [&](int b) {
+            // every class at once, a row is whole SIMD registers. each class still gets its adds in block order.
+            const float *row = &blockVotes[(size_t)b * voteStride];
+            #pragma omp simd
+            for (int cls = 0; cls < voteStride; cls++)
+                sums[cls] += row[cls];
+            if (hits)
+                hits->push_back(BlockInfo{blockClass[b], blockIds[b], blockSizes[b], -1});
+            return true;
+        });
+
+        // first class with the most wins, nothing at all is -1.
+        float maxVote = 0.0f;
+        int winner = -1;
+        for (int cls = 0; cls < numClasses; cls++) {
+            if (votes[cls] > maxVote) {
+                maxVote = votes[cls];
+                winner = cls;
+            }
+        }
+        return winner;
+    }
+
+    boxes.forEachContaining(point, scratch.boxes, [&](int b) {
+        // every block of a class adds the same weight, so the order we add them in doesn't change the sums.
+        votes[blockClass[b]] += blockWeight[b];
+        if (hits)
+            hits->push_back(BlockInfo{blockClass[b], blockIds[b], blockSizes[b], -1});
+        return true;
+    });
+
+    float maxVote = 0.0f;
+    int winner = -1;
+    int countMax = 0;
+    for (int cls = 0; cls < numClasses; cls++) {
+        if (votes[cls] > maxVote) {
+            maxVote = votes[cls];
+            winner = cls;
+            countMax = 1;
+        }
+        else if (votes[cls] == maxVote && maxVote > 0.0f) {
+            countMax++;
+        }
+    }
+
+    // nothing, or more than one class with the same vote.
+    if (winner == -1 || countMax > 1)
+        return -1;
+    return winner;
+}
+
+int HyperBlockModel::predict(const vector<float> &point, vector<BlockInfo> *hits) const {
+    Scratch scratch(*this);
+    return predict(point.data(), scratch, hits);
+}
+
+void HyperBlockModel::predictBatch(const float *points, int numPoints, int *out) const {
+    #pragma omp parallel
+    {
+        Scratch scratch(*this);
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int p = 0; p < numPoints; p++)
+            out[p] = predict(&points[(size_t)p * numAttributes], scratch);
+    }
+}
+
+void HyperBlockModel::predictBatch(const vector<vector<float>> &points, vector<int> &out) const {
+    out.resize(points.size());
+
+    #pragma omp parallel
+    {
+        Scratch scratch(*this);
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int p = 0; p < (int)points.size(); p++)
+            out[p] = predict(points[p].data(), scratch);
+    }
+}
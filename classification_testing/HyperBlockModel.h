@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include "../hyperblock/HyperBlock.h"
+#include "../hyperblock/BlockBoxes.h"
+#include "../data_utilities/StatStructs.h"
+
+#ifndef HYPERBLOCKMODEL_H
+#define HYPERBLOCKMODEL_H
+
+using namespace std;
+
+/**
+ * The blocks "compiled" down for classifying with, so predicting doesn't touch the HyperBlock objects at all.
+ *
+ * The containment tests are a BlockBoxes, this just adds the class, vote weight and id of every block on top.
+ *
+ * Every block the point is in (inside_HB, EPSILON on every comparison) votes 1 / blocks of its class for its class. the class with the most wins,
+ * a tie or no block at all is -1.
+ *
+ * Made with precisionWeighted every block's whole vote (blockPrecision / blocks in its class for its own class, precisionLostByClass / blocks in its
+ * class for the others) gets worked out once into its row of blockVotes instead, and predicting just adds up the rows of the blocks the point is in,
+ * in block order, so the sums come out exactly like ClassificationTests::precisionWeightedHBs. the winner is the first class with the most,
+ * no tie check. the blocks need setHBPrecisions run on them first.
+ *
+ * Build it again after the blocks change.
+ */
+class HyperBlockModel {
+public:
+    HyperBlockModel() = default;
+    HyperBlockModel(const vector<HyperBlock> &hyperBlocks, int numAttributes, int numClasses, bool precisionWeighted = false);
+
+    // what one thread needs for predicting, so a caller looping over points can keep reusing one.
+    struct Scratch {
+        vector<float> votes;
+        BlockBoxes::Scratch boxes;
+        Scratch() = default;
+        explicit Scratch(const HyperBlockModel &model) : votes(model.voteStride), boxes(model.boxes) {}
+    };
+
+    // the class of one point, -1 if it's in no block or there's a tie. hits gets every block the point is in, if it isn't null.
+    int predict(const float *point, Scratch &scratch, vector<BlockInfo> *hits = nullptr) const;
+    int predict(const vector<float> &point, vector<BlockInfo> *hits = nullptr) const;
+
+    // points is numPoints rows of numAttributes, out gets the class of each one. split across the OpenMP threads, nothing gets allocated per point.
+    void predictBatch(const float *points, int numPoints, int *out) const;
+    void predictBatch(const vector<vector<float>> &points, vector<int> &out) const;
+
+    int numBlocks() const { return boxes.numBlocks(); }
+
+private:
+    int numAttributes = 0;
+    int numClasses = 0;
+    bool precisionWeighted = false;
+    int voteStride = 0;             // how long the votes are. numClasses, or rounded up to BOX_LANES for the precision weighted rows
+
+    BlockBoxes boxes;
+    vector<int> blockClass;
+    vector<float> blockWeight;      // 1 / how many blocks its class has
+    vector<int> blockIds;
+    vector<int> blockSizes;
+    vector<float, AlignedAllocator<float>> blockVotes;     // precision weighted only, block b's row starts at b * voteStride. the padding is 0
+};
+
+#endif //HYPERBLOCKMODEL_H
@@ -0,0 +1,87 @@
+#include "OneToOneModel.h"
+#include <algorithm>
+#include <omp.h>
+
+OneToOneModel::OneToOneModel(const vector<vector<HyperBlock>> &oneToOneHBs, const vector<pair<int, int>> &classPairs, int numAttributes, int numClasses) : numAttributes(numAttributes), numClasses(numClasses) {
+
+    // the first set classPairs has for each pair, the same one evaluateOneToOneHyperBlocks would find.
+    pairTable.assign(numClasses * numClasses, -1);
+    for (int idx = (int)classPairs.size() - 1; idx >= 0; idx--) {
+        const int a = classPairs[idx].first;
+        const int b = classPairs[idx].second;
+        if (a < 0 || b < 0 || a >= numClasses || b >= numClasses)
+            continue;
+        pairTable[a * numClasses + b] = idx;
+        pairTable[b * numClasses + a] = idx;
+    }
+
+    // where every set starts, block numbers count up through all of them.
+    vector<int> setStart(oneToOneHBs.size() + 1, 0);
+    for (int s = 0; s < (int)oneToOneHBs.size(); s++)
+        setStart[s + 1] = setStart[s] + oneToOneHBs[s].size();
+
+    // the blocks which vote, pair after pair. a block of neither class in its pair never votes, so it doesn't need testing.
+    vector<HyperBlock> voters;
+    for (int i = 0; i < numClasses; i++) {
+        for (int j = i + 1; j < numClasses; j++) {
+            const int set = pairSet(i, j);
+            if (set == -1 || set >= (int)oneToOneHBs.size()) {
+                missing.emplace_back(i, j);
+                continue;
+            }
+
+            for (int b = 0; b < (int)oneToOneHBs[set].size(); b++) {
+                const HyperBlock &hb = oneToOneHBs[set][b];
+                if (hb.classNum != i && hb.classNum != j)
+                    continue;
+                voters.push_back(hb);
+                blockClass.push_back(hb.classNum);
+                blockNumber.push_back(setStart[set] + b);
+            }
+        }
+    }
+
+    boxes = BlockBoxes(voters, numAttributes);
+}
+
+int OneToOneModel::predict(const float *point, Scratch &scratch, vector<int> *hits) const {
+    vector<int> &votes = scratch.votes;
+    fill(votes.begin(), votes.end(), 0);
+
+    boxes.forEachContaining(point, scratch.boxes, [&](int b) {
+        votes[blockClass[b]]++;
+        if (hits)
+            hits->push_back(blockNumber[b]);
+        return true;
+    });
+
+    // majority vote, the first class with the most.
+    const int predicted = max_element(votes.begin(), votes.end()) - votes.begin();
+    if (votes[predicted] == 0)
+        return -1;
+    return predicted;
+}
+
+void OneToOneModel::predictBatch(const float *points, int numPoints, int *out) const {
+    #pragma omp parallel
+    {
+        Scratch scratch(*this);
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int p = 0; p < numPoints; p++)
+            out[p] = predict(&points[(size_t)p * numAttributes], scratch);
+    }
+}
+
+void OneToOneModel::predictBatch(const vector<vector<float>> &points, vector<int> &out) const {
+    out.resize(points.size());
+
+    #pragma omp parallel
+    {
+        Scratch scratch(*this);
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int p = 0; p < (int)points.size(); p++)
+            out[p] = predict(points[p].data(), scratch);
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "../hyperblock/HyperBlock.h"
+#include "../hyperblock/BlockBoxes.h"
+
+#ifndef ONETOONEMODEL_H
+#define ONETOONEMODEL_H
+
+using namespace std;
+
+/**
+ * The one to one blocks "compiled" down for classifying with, same answers as evaluateOneToOneHyperBlocks.
+ *
+ * Which block set every pair of classes i < j uses gets looked up once, into a numClasses x numClasses table (the first set in classPairs
+ * for the pair, either way around). only the blocks of a set that vote, the ones of class i or j, are kept, and all of them from every pair go
+ * into one BlockBoxes. so a point gets one containment test per block, and every block it's inside of is one vote for its class.
+ * the class with the most votes wins, the lowest one on a tie, -1 if nothing voted.
+ *
+ * Build it again after the blocks change.
+ */
+class OneToOneModel {
+public:
+    OneToOneModel() = default;
+    OneToOneModel(const vector<vector<HyperBlock>> &oneToOneHBs, const vector<pair<int, int>> &classPairs, int numAttributes, int numClasses);
+
+    // what one thread needs for predicting. make one per thread and keep reusing it.
+    struct Scratch {
+        vector<int> votes;
+        BlockBoxes::Scratch boxes;
+        Scratch() = default;
+        explicit Scratch(const OneToOneModel &model) : votes(model.numClasses), boxes(model.boxes) {}
+    };
+
+    // the class of one point, -1 if no block voted. hits gets the blocks that voted, numbered counting up through every set in oneToOneHBs, if it isn't null.
+    int predict(const float *point, Scratch &scratch, vector<int> *hits = nullptr) const;
+
+    // points is numPoints rows of numAttributes, out gets the class of each one. split across the OpenMP threads.
+    void predictBatch(const float *points, int numPoints, int *out) const;
+    void predictBatch(const vector<vector<float>> &points, vector<int> &out) const;
+
+    // the set index classPairs gave the pair, -1 if there isn't one.
+    int pairSet(int classA, int classB) const { return pairTable[classA * numClasses + classB]; }
+    // the pairs i < j nothing was found for, they just don't vote.
+    const vector<pair<int, int>> &missingPairs() const { return missing; }
+    int numBlocks() const { return boxes.numBlocks(); }
+
+private:
+    int numAttributes = 0;
+    int numClasses = 0;
+
+    vector<int> pairTable;              // numClasses x numClasses, both ways around
+    vector<pair<int, int>> missing;
+
+    BlockBoxes boxes;
+    vector<int> blockClass;             // the class each block votes for
+    vector<int> blockNumber;            // where it was in oneToOneHBs, counting up through every set
+};
+
+#endif //ONETOONEMODEL_H
@@ -276,6 +276,21 @@ void DataUtil::normalizeTestSet(vector<vector<vector<float>>>& testSet, const ve
 
 
 
+}
+
+// one point the same way normalizeTestSet does it, minus the printing. for points coming in one at a time.
+void DataUtil::normalizePoint(float* point, const vector<float>& minValues, const vector<float>& maxValues, int FIELD_LENGTH) {
+    for (int k = 0; k < FIELD_LENGTH; k++) {
+        if (maxValues[k] != minValues[k])
+            point[k] = (point[k] - minValues[k]) / (maxValues[k] - minValues[k]);
+        else
+            point[k] = 0.50000f;
+
+        if (point[k] > 1.0f)
+            point[k] = 1.000000f;
+        if (point[k] < 0.0f)
+            point[k] = 0.000000f;
+    }
 }
 
 // normalizes the training data using just the min and max value in each attribute
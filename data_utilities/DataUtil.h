@@ -21,6 +21,7 @@ class DataUtil {
 public:
     static vector<vector<vector<float>>> dataSetup(const string filepath, map<string, int>& classMap, map<int, string>& reversedClassMap);
     static void normalizeTestSet(vector<vector<vector<float>>>& testSet, const vector<float>& minValues, const vector<float>& maxValues, int FIELD_LENGTH);
+    static void normalizePoint(float* point, const vector<float>& minValues, const vector<float>& maxValues, int FIELD_LENGTH);
     static void minMaxNormalization(vector<vector<vector<float>>>& dataset, const vector<float>& minValues, const vector<float>& maxValues, int FIELD_LENGTH);
     static vector<vector<vector<float>>> reorderTestingDataset(const vector<vector<vector<float>>>& testingData, const map<string, int>& CLASS_MAP_TRAINING, const map<string, int>& CLASS_MAP_TESTING);
     static void findMinMaxValuesInDataset(const vector<vector<vector<float>>>& dataset, vector<float>& minValues, vector<float>& maxValues, int FIELD_LENGTH);
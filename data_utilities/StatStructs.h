@@ -6,6 +6,8 @@
 #include <map>
 #include <vector>
 #include <utility>
+#include <algorithm>
+#include <string>
 #include <fstream>
 #include <iostream>
 
@@ -18,15 +20,24 @@ struct BlockInfo {
     float blockDensity;
 };
 
-// Keep track of the classification behavior of our points into blocks with this struct.
-struct PointSummary {
-    int classIdx;
-    int pointIdx;
-    int predictedIdx;         // THE CLASS IDX IT WAS PREDICTED AS OVERALL!!!!
-    std::vector<BlockInfo> blockHits;
+// Keep track of the classification behavior of our points into blocks with this struct. one buildConfusionMatrix call fills it in for all its points.
+// points are numbered class after class, point p of class c is number classStart[c] + p. the block hits of all the points share one buffer,
+// point n's hits are hits[hitStart[n]] up to hits[hitStart[n + 1]]. only the points which got classified have hits in here.
+struct PointSummaries {
+    std::vector<int> classStart;        // first point number of each class, and the total on the end
+    std::vector<int> predicted;         // THE CLASS IDX EACH POINT WAS PREDICTED AS OVERALL!!!! -1 if it wasn't
+    std::vector<int> hitStart;
+    std::vector<BlockInfo> hits;
+
+    int numPoints() const { return predicted.size(); }
+    int pointNumber(int classIdx, int pointIdx) const { return classStart[classIdx] + pointIdx; }
+    int classOf(int n) const { return std::upper_bound(classStart.begin(), classStart.end(), n) - classStart.begin() - 1; }
+    int pointIdxOf(int n) const { return n - classStart[classOf(n)]; }
+    const BlockInfo* hitsBegin(int n) const { return hits.data() + hitStart[n]; }
+    const BlockInfo* hitsEnd(int n) const { return hits.data() + hitStart[n + 1]; }
 };
 
-inline void printPointSummariesToCSV(const std::map<std::pair<int, int>, PointSummary>& pointSummaries, const std::string& filename) {
+inline void printPointSummariesToCSV(const PointSummaries& pointSummaries, const std::string& filename) {
     std::ofstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Error opening file: " << filename << std::endl;
@@ -35,18 +46,17 @@ inline void printPointSummariesToCSV(const std::map<std::pair<int, int>, PointSu
 
     file << "classIdx,pointIdx,predIdx,blockClassIdx,blockIdx,blockSize,blockDensity\n";
 
-    std::map<std::pair<int, int>, PointSummary>::const_iterator it;
-    for (it = pointSummaries.begin(); it != pointSummaries.end(); ++it) {
-        const PointSummary& summary = it->second;
-        for (size_t i = 0; i < summary.blockHits.size(); ++i) {
-            const BlockInfo& hit = summary.blockHits[i];
-            file << summary.classIdx << ","
-                 << summary.pointIdx << ","
-                 << summary.predictedIdx << ","
-                 << hit.blockClass << ","
-                 << hit.blockIdx << ","
-                 << hit.blockSize << ","
-                 << hit.blockDensity << "\n";
+    for (int n = 0; n < pointSummaries.numPoints(); ++n) {
+        if (pointSummaries.predicted[n] == -1)
+            continue;
+        for (const BlockInfo* hit = pointSummaries.hitsBegin(n); hit != pointSummaries.hitsEnd(n); ++hit) {
+            file << pointSummaries.classOf(n) << ","
+                 << pointSummaries.pointIdxOf(n) << ","
+                 << pointSummaries.predicted[n] << ","
+                 << hit->blockClass << ","
+                 << hit->blockIdx << ","
+                 << hit->blockSize << ","
+                 << hit->blockDensity << "\n";
         }
     }
 
@@ -0,0 +1,329 @@
+#include "BlockBoxes.h"
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HB_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// same tolerance inside_HB uses.
+static constexpr float EPSILON = 1e-6f;
+
+BlockBoxes::BlockBoxes(const vector<HyperBlock> &blocks, int numAttributes) : numAttributes(numAttributes) {
+    blockCount = blocks.size();
+    numChunks = (blockCount + BOX_LANES - 1) / BOX_LANES;
+    intervalStart.assign(blockCount, -1);
+
+    // the hull of every block, [block * numAttributes + a]. an attribute with no intervals stays an empty box.
+    hullMins.assign((size_t)blockCount * numAttributes, numeric_limits<float>::infinity());
+    hullMaxes.assign((size_t)blockCount * numAttributes, -numeric_limits<float>::infinity());
+
+    vector<double> widths(numAttributes, 0.0);
+    for (int b = 0; b < blockCount; b++) {
+        const HyperBlock &hb = blocks[b];
+        bool disjunction = false;
+        for (int a = 0; a < numAttributes; a++) {
+            const size_t at = (size_t)b * numAttributes + a;
+            for (int j = 0; j < (int)hb.maximums[a].size(); j++) {
+                hullMins[at] = min(hullMins[at], hb.minimums[a][j]);
+                hullMaxes[at] = max(hullMaxes[at], hb.maximums[a][j]);
+            }
+            if (hb.maximums[a].size() > 1)
+                disjunction = true;
+            if (!hb.maximums[a].empty())
+                widths[a] += hullMaxes[at] - hullMins[at];
+        }
+
+        if (disjunction) {
+            intervalStart[b] = intervals.size();
+            for (int a = 0; a < numAttributes; a++) {
+                intervals.push_back(hb.maximums[a].size());
+                for (int j = 0; j < (int)hb.maximums[a].size(); j++) {
+                    intervals.push_back(hb.minimums[a][j]);
+                    intervals.push_back(hb.maximums[a][j]);
+                }
+            }
+        }
+    }
+
+    attributeOrder.resize(numAttributes);
+    iota(attributeOrder.begin(), attributeOrder.end(), 0);
+    stable_sort(attributeOrder.begin(), attributeOrder.end(), [&](int x, int y) { return widths[x] < widths[y]; });
+
+    laneBlock.assign((size_t)numChunks * BOX_LANES, -1);
+    iota(laneBlock.begin(), laneBlock.begin() + blockCount, 0);
+
+    if (blockCount >= BOX_TREE_MIN_BLOCKS) {
+        // centers to split on. an empty block has no center, it just goes on the low side.
+        vector<float> centers((size_t)blockCount * numAttributes);
+        for (size_t i = 0; i < centers.size(); i++)
+            centers[i] = hullMins[i] <= hullMaxes[i] ? (hullMins[i] + hullMaxes[i]) * 0.5f : -numeric_limits<float>::infinity();
+        buildTree(0, blockCount, centers);
+    }
+
+    // now lay the chunks out, whatever order the lanes ended up in.
+    const size_t boundsLength = (size_t)numChunks * numAttributes * BOX_LANES;
+    mins.assign(boundsLength, numeric_limits<float>::infinity());
+    maxes.assign(boundsLength, -numeric_limits<float>::infinity());
+    for (int lane = 0; lane < blockCount; lane++) {
+        const int b = laneBlock[lane];
+        for (int a = 0; a < numAttributes; a++) {
+            const size_t at = ((size_t)(lane / BOX_LANES) * numAttributes + a) * BOX_LANES + lane % BOX_LANES;
+            mins[at] = hullMins[(size_t)b * numAttributes + a];
+            maxes[at] = hullMaxes[(size_t)b * numAttributes + a];
+        }
+    }
+
+    // only needed while building.
+    vector<float>().swap(hullMins);
+    vector<float>().swap(hullMaxes);
+}
+
+void BlockBoxes::buildTree(int lo, int hi, const vector<float> &centers) {
+    const int node = nodeSkip.size();
+    nodeSkip.push_back(-1);
+    nodeChunk.push_back(-1);
+
+    // the box around every block under this node.
+    nodeMins.resize(nodeMins.size() + numAttributes, numeric_limits<float>::infinity());
+    nodeMaxes.resize(nodeMaxes.size() + numAttributes, -numeric_limits<float>::infinity());
+    float *boxMins = &nodeMins[(size_t)node * numAttributes];
+    float *boxMaxes = &nodeMaxes[(size_t)node * numAttributes];
+    for (int i = lo; i < hi; i++) {
+        const int b = laneBlock[i];
+        for (int a = 0; a < numAttributes; a++) {
+            boxMins[a] = min(boxMins[a], hullMins[(size_t)b * numAttributes + a]);
+            boxMaxes[a] = max(boxMaxes[a], hullMaxes[(size_t)b * numAttributes + a]);
+        }
+    }
+
+    // lo is always on a chunk boundary, so one chunk worth of blocks is a leaf.
+    if (hi - lo <= BOX_LANES) {
+        nodeChunk[node] = lo / BOX_LANES;
+        nodeSkip[node] = node + 1;
+        return;
+    }
+
+    // split on the attribute the centers are most spread out on. that's the one that tells the two halves apart best.
+    int splitAttribute = 0;
+    float widestSpread = -1.0f;
+    for (int a = 0; a < numAttributes; a++) {
+        float low = numeric_limits<float>::infinity();
+        float high = -numeric_limits<float>::infinity();
+        for (int i = lo; i < hi; i++) {
+            const float c = centers[(size_t)laneBlock[i] * numAttributes + a];
+            if (c == -numeric_limits<float>::infinity())
+                continue;
+            low = min(low, c);
+            high = max(high, c);
+        }
+        if (high - low > widestSpread) {
+            widestSpread = high - low;
+            splitAttribute = a;
+        }
+    }
+
+    // the median, rounded up to a whole chunk so every leaf but the last one is full.
+    const int half = (hi - lo) / 2;
+    const int mid = lo + (half + BOX_LANES - 1) / BOX_LANES * BOX_LANES;
+    nth_element(laneBlock.begin() + lo, laneBlock.begin() + mid, laneBlock.begin() + hi, [&](int x, int y) {
+        return centers[(size_t)x * numAttributes + splitAttribute] < centers[(size_t)y * numAttributes + splitAttribute];
+    });
+
+    buildTree(lo, mid, centers);
+    buildTree(mid, hi, centers);
+    nodeSkip[node] = nodeSkip.size();
+}
+
+// ------------------------ the chunk kernels. each gives back a bit per lane whose box has the point inside. -------------------------
+// pointPlus / pointMinus are the point +- EPSILON, so the compares are the exact same float math as inside_HB.
+
+static unsigned chunkInsideScalar(const float *chunkMins, const float *chunkMaxes, const int *attributeOrder, const int numAttributes, const float *pointPlus, const float *pointMinus) {
+    unsigned inside = (1u << BOX_LANES) - 1;
+    for (int k = 0; k < numAttributes && inside; k++) {
+        const int a = attributeOrder[k];
+        const float *attrMins = &chunkMins[a * BOX_LANES];
+        const float *attrMaxes = &chunkMaxes[a * BOX_LANES];
+        for (int l = 0; l < BOX_LANES; l++)
+            if (!(pointPlus[a] >= attrMins[l] && pointMinus[a] <= attrMaxes[l]))
+                inside &= ~(1u << l);
+    }
+    return inside;
+}
+
+#ifdef HB_X86_SIMD
+// SSE2, every x86-64 has it. the 16 lanes are 4 registers.
+__attribute__((target("sse2")))
+static unsigned chunkInsideSSE2(const float *chunkMins, const float *chunkMaxes, const int *attributeOrder, const int numAttributes, const float *pointPlus, const float *pointMinus) {
+    __m128 inside[BOX_LANES / 4];
+    for (int i = 0; i < BOX_LANES / 4; i++)
+        inside[i] = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+    for (int k = 0; k < numAttributes; k++) {
+        const int a = attributeOrder[k];
+        const __m128 plus = _mm_set1_ps(pointPlus[a]);
+        const __m128 minus = _mm_set1_ps(pointMinus[a]);
+        __m128 any = _mm_setzero_ps();
+        for (int i = 0; i < BOX_LANES / 4; i++) {
+            const __m128 in = _mm_and_ps(_mm_cmpge_ps(plus, _mm_load_ps(&chunkMins[a * BOX_LANES + i * 4])), _mm_cmple_ps(minus, _mm_load_ps(&chunkMaxes[a * BOX_LANES + i * 4])));
+            inside[i] = _mm_and_ps(inside[i], in);
+            any = _mm_or_ps(any, inside[i]);
+        }
+
+        // every lane is out already.
+        if (!_mm_movemask_ps(any))
+            return 0;
+    }
+
+    unsigned mask = 0;
+    for (int i = 0; i < BOX_LANES / 4; i++)
+        mask |= (unsigned)_mm_movemask_ps(inside[i]) << (i * 4);
+    return mask;
+}
+
+// AVX2, two registers of 8 lanes.
+__attribute__((target("avx2")))
+static unsigned chunkInsideAVX2(const float *chunkMins, const float *chunkMaxes, const int *attributeOrder, const int numAttributes, const float *pointPlus, const float *pointMinus) {
+    __m256 insideLow = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    __m256 insideHigh = insideLow;
+
+    for (int k = 0; k < numAttributes; k++) {
+        const int a = attributeOrder[k];
+        const __m256 plus = _mm256_set1_ps(pointPlus[a]);
+        const __m256 minus = _mm256_set1_ps(pointMinus[a]);
+        const float *attrMins = &chunkMins[a * BOX_LANES];
+        const float *attrMaxes = &chunkMaxes[a * BOX_LANES];
+
+        insideLow = _mm256_and_ps(insideLow, _mm256_and_ps(_mm256_cmp_ps(plus, _mm256_load_ps(attrMins), _CMP_GE_OQ), _mm256_cmp_ps(minus, _mm256_load_ps(attrMaxes), _CMP_LE_OQ)));
+        insideHigh = _mm256_and_ps(insideHigh, _mm256_and_ps(_mm256_cmp_ps(plus, _mm256_load_ps(attrMins + 8), _CMP_GE_OQ), _mm256_cmp_ps(minus, _mm256_load_ps(attrMaxes + 8), _CMP_LE_OQ)));
+
+        if (_mm256_testz_ps(_mm256_or_ps(insideLow, insideHigh), _mm256_or_ps(insideLow, insideHigh)))
+            return 0;
+    }
+    return (unsigned)_mm256_movemask_ps(insideLow) | ((unsigned)_mm256_movemask_ps(insideHigh) << 8);
+}
+
+// AVX-512, the whole chunk in one register and the mask comes straight out of the compare.
+__attribute__((target("avx512f")))
+static unsigned chunkInsideAVX512(const float *chunkMins, const float *chunkMaxes, const int *attributeOrder, const int numAttributes, const float *pointPlus, const float *pointMinus) {
+    __mmask16 inside = 0xFFFF;
+    for (int k = 0; k < numAttributes && inside; k++) {
+        const int a = attributeOrder[k];
+        inside = _mm512_mask_cmp_ps_mask(inside, _mm512_set1_ps(pointPlus[a]), _mm512_load_ps(&chunkMins[a * BOX_LANES]), _CMP_GE_OQ);
+        inside = _mm512_mask_cmp_ps_mask(inside, _mm512_set1_ps(pointMinus[a]), _mm512_load_ps(&chunkMaxes[a * BOX_LANES]), _CMP_LE_OQ);
+    }
+    return inside;
+}
+#endif
+
+typedef unsigned (*ChunkInsideFn)(const float*, const float*, const int*, const int, const float*, const float*);
+
+// pick the widest kernel this cpu can actually run. only done once.
+static ChunkInsideFn pickChunkInside(const char **levelName) {
+#ifdef HB_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        *levelName = "AVX-512";
+        return chunkInsideAVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        *levelName = "AVX2";
+        return chunkInsideAVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        *levelName = "SSE2";
+        return chunkInsideSSE2;
+    }
+#endif
+    *levelName = "scalar";
+    return chunkInsideScalar;
+}
+
+static const char *boxSimdLevelName = "scalar";
+static const ChunkInsideFn chunkInsideKernel = pickChunkInside(&boxSimdLevelName);
+
+const char* BlockBoxes::simdLevel() {
+    return boxSimdLevelName;
+}
+
+void BlockBoxes::prepare(const float *point, Scratch &scratch) const {
+    for (int a = 0; a < numAttributes; a++) {
+        scratch.pointPlus[a] = point[a] + EPSILON;
+        scratch.pointMinus[a] = point[a] - EPSILON;
+    }
+}
+
+unsigned BlockBoxes::chunkInside(int chunk, const float *pointPlus, const float *pointMinus) const {
+    const size_t offset = (size_t)chunk * numAttributes * BOX_LANES;
+    return chunkInsideKernel(&mins[offset], &maxes[offset], attributeOrder.data(), numAttributes, pointPlus, pointMinus);
+}
+
+bool BlockBoxes::insideNode(int node, const float *pointPlus, const float *pointMinus) const {
+    const float *boxMins = &nodeMins[(size_t)node * numAttributes];
+    const float *boxMaxes = &nodeMaxes[(size_t)node * numAttributes];
+    for (int k = 0; k < numAttributes; k++) {
+        const int a = attributeOrder[k];
+        if (!(pointPlus[a] >= boxMins[a] && pointMinus[a] <= boxMaxes[a]))
+            return false;
+    }
+    return true;
+}
+
+void BlockBoxes::treeHits(Scratch &scratch) const {
+    const float *pointPlus = scratch.pointPlus.data();
+    const float *pointMinus = scratch.pointMinus.data();
+    scratch.hits.clear();
+
+    const int numNodes = nodeSkip.size();
+    int node = 0;
+    while (node < numNodes) {
+        if (!insideNode(node, pointPlus, pointMinus)) {
+            node = nodeSkip[node];
+            continue;
+        }
+
+        const int chunk = nodeChunk[node];
+        if (chunk != -1) {
+            unsigned inside = chunkInside(chunk, pointPlus, pointMinus);
+            while (inside) {
+                scratch.hits.push_back(laneBlock[chunk * BOX_LANES + __builtin_ctz(inside)]);
+                inside &= inside - 1;
+            }
+        }
+        node++;
+    }
+
+    // the chunks are in tree order, the callers want block order.
+    sort(scratch.hits.begin(), scratch.hits.end());
+}
+
+bool BlockBoxes::insideIntervals(int block, const float *pointPlus, const float *pointMinus) const {
+    const float *at = &intervals[intervalStart[block]];
+    for (int a = 0; a < numAttributes; a++) {
+        const int count = (int)*at++;
+        bool inAnInterval = false;
+        for (int j = 0; j < count && !inAnInterval; j++)
+            inAnInterval = pointPlus[a] >= at[2 * j] && pointMinus[a] <= at[2 * j + 1];
+        if (!inAnInterval)
+            return false;
+        at += 2 * count;
+    }
+    return true;
+}
+
+int BlockBoxes::firstContaining(const float *point, Scratch &scratch) const {
+    int first = -1;
+    forEachContaining(point, scratch, [&](int b) {
+        first = b;
+        return false;
+    });
+    return first;
+}
+
+bool BlockBoxes::anyContaining(const float *point, Scratch &scratch) const {
+    return firstContaining(point, scratch) != -1;
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <vector>
+#include <new>
+#include "HyperBlock.h"
+
+#ifndef BLOCKBOXES_H
+#define BLOCKBOXES_H
+
+using namespace std;
+
+// how many blocks one containment test covers. one AVX-512 register, or two AVX2 ones.
+#define BOX_LANES 16
+// under this many blocks the tree costs more than it saves, the chunks just get tested in order.
+#define BOX_TREE_MIN_BLOCKS 256
+
+// so a chunk's attribute row (16 floats) lines up with a cache line / AVX-512 register.
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U> &) {}
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), align_val_t(64))); }
+    void deallocate(T *p, size_t) { ::operator delete(p, align_val_t(64)); }
+    template <typename U> bool operator==(const AlignedAllocator<U> &) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U> &) const { return false; }
+};
+
+/**
+ * The bounds of a set of blocks transposed for testing one point against all of them, which is what classifying, find_avg_and_size_all
+ * and generateNextLevelHBs all do. same answers as inside_HB, EPSILON included.
+ *
+ * The blocks go in chunks of BOX_LANES, and inside a chunk attribute by attribute: chunk c, attribute a, lane l is at [(c * numAttributes + a) * BOX_LANES + l].
+ * a point gets tested against a whole chunk at once (AVX-512, AVX2 or SSE2, whatever the cpu has, picked at runtime), keeping a still inside mask per lane
+ * and quitting the chunk once every lane is out. a block with a disjunction gets the hull of its intervals in there, and its real intervals checked after.
+ * the empty lanes on the end of the last chunk are an empty box, nothing is ever inside them.
+ *
+ * With BOX_TREE_MIN_BLOCKS blocks or more there's a bounding volume hierarchy on top. the blocks get sorted into chunks by median splits on the attribute
+ * their centers are most spread out on, so a chunk holds blocks near each other, and every node keeps the box around everything under it. a point only gets
+ * tested against the chunks whose nodes it's inside of. a node box holds all of its blocks, so no hit ever gets skipped, the hits come back exactly the same.
+ *
+ * Build it again after the blocks change.
+ */
+class BlockBoxes {
+public:
+    BlockBoxes() = default;
+    BlockBoxes(const vector<HyperBlock> &blocks, int numAttributes);
+
+    // what one thread needs for testing points. make one per thread and keep reusing it.
+    struct Scratch {
+        vector<float> pointPlus;
+        vector<float> pointMinus;
+        vector<int> hits;
+        Scratch() = default;
+        explicit Scratch(const BlockBoxes &boxes) : pointPlus(boxes.numAttributes), pointMinus(boxes.numAttributes) { hits.reserve(boxes.blockCount); }
+    };
+
+    int numBlocks() const { return blockCount; }
+    bool hasTree() const { return !nodeSkip.empty(); }
+
+    // calls visit(block) for every block the point is inside of, lowest block first. visit returns false to stop early.
+    template <typename Visit>
+    void forEachContaining(const float *point, Scratch &scratch, Visit visit) const {
+        const float *pointPlus = scratch.pointPlus.data();
+        const float *pointMinus = scratch.pointMinus.data();
+        prepare(point, scratch);
+
+        if (hasTree()) {
+            treeHits(scratch);
+            for (const int b : scratch.hits) {
+                if (intervalStart[b] != -1 && !insideIntervals(b, pointPlus, pointMinus))
+                    continue;
+                if (!visit(b))
+                    return;
+            }
+            return;
+        }
+
+        // no tree, the lanes are still in block order.
+        for (int chunk = 0; chunk < numChunks; chunk++) {
+            unsigned inside = chunkInside(chunk, pointPlus, pointMinus);
+            while (inside) {
+                const int b = chunk * BOX_LANES + __builtin_ctz(inside);
+                inside &= inside - 1;
+                if (intervalStart[b] != -1 && !insideIntervals(b, pointPlus, pointMinus))
+                    continue;
+                if (!visit(b))
+                    return;
+            }
+        }
+    }
+
+    // lowest block the point is inside of, -1 for none. what a first-match classifier wants.
+    int firstContaining(const float *point, Scratch &scratch) const;
+
+    // is the point inside any of the blocks.
+    bool anyContaining(const float *point, Scratch &scratch) const;
+
+    // which kernel we ended up with, for printing.
+    static const char* simdLevel();
+
+private:
+    // the point +- EPSILON into the scratch.
+    void prepare(const float *point, Scratch &scratch) const;
+    unsigned chunkInside(int chunk, const float *pointPlus, const float *pointMinus) const;
+    // walks the tree, scratch.hits gets every block whose hull has the point inside, lowest first.
+    void treeHits(Scratch &scratch) const;
+    bool insideNode(int node, const float *pointPlus, const float *pointMinus) const;
+    // makes the nodes for laneBlock[lo, hi), reordering it on the way.
+    void buildTree(int lo, int hi, const vector<float> &centers);
+    // the real test for a block with a disjunction.
+    bool insideIntervals(int block, const float *pointPlus, const float *pointMinus) const;
+
+    int numAttributes = 0;
+    int blockCount = 0;
+    int numChunks = 0;
+
+    vector<float, AlignedAllocator<float>> mins;
+    vector<float, AlignedAllocator<float>> maxes;
+    vector<int> attributeOrder;     // narrowest attributes first, they throw points out of a chunk soonest
+    vector<float> hullMins;         // the hull of every block, only kept while building
+    vector<float> hullMaxes;
+    vector<int> laneBlock;          // which block is in each lane, -1 for the empty ones on the end. just 0..n-1 without the tree
+
+    // the tree, nodes in depth first order. inside a node means go on to the next one, outside means jump to nodeSkip, past everything under it.
+    // leaves have their chunk in nodeChunk, -1 for the rest.
+    vector<float> nodeMins;
+    vector<float> nodeMaxes;
+    vector<int> nodeSkip;
+    vector<int> nodeChunk;
+
+    // every interval of the blocks with disjunctions, count then min max pairs for every attribute. -1 start for blocks without any.
+    vector<int> intervalStart;
+    vector<float> intervals;
+};
+
+#endif //BLOCKBOXES_H
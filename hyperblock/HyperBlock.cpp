@@ -1,4 +1,8 @@
 #include "HyperBlock.h"
+#include "BlockBoxes.h"
+#include <algorithm>
+#include <numeric>
+#include <omp.h>
 
 using namespace std;
 
@@ -37,10 +41,13 @@ HyperBlock::HyperBlock(vector<vector<vector<float>>>& hb_data, int cls){
 }
 
 // a point is inside a hyperblock if it is inside ALL attributes. it is outside if even one attribute is outside the bounds.
+// the attributes go in checkOrder, so the one most likely to throw the point out gets looked at first.
 bool HyperBlock::inside_HB(int numAttributes, const float* point) const {
     constexpr float EPSILON = 1e-6f;  // Small tolerance value
+    const bool ordered = checkOrder.size() == numAttributes;
 
-    for (int i = 0; i < numAttributes; i++) {
+    for (int k = 0; k < numAttributes; k++) {
+        const int i = ordered ? checkOrder[k] : k;
         bool inAnInterval = false;
 
         // inner loop here is in case of a disjunction. in 99% of cases, we can pretend there is no loop here.
@@ -61,6 +68,78 @@ bool HyperBlock::inside_HB(int numAttributes, const float* point) const {
 }
 
 
+// how many points/blocks we look at to guess which attributes reject the most. it's only an ordering, so a rough guess is fine.
+#define REJECTION_SAMPLE_POINTS 256
+#define REJECTION_SAMPLE_BLOCKS 64
+
+// evenly spaced points from every class except skipClass (-1 to keep them all).
+static vector<const float*> sampleRejectionPoints(const vector<vector<vector<float>>>& data, int skipClass) {
+    size_t total = 0;
+    for (int c = 0; c < data.size(); c++)
+        if (c != skipClass) total += data[c].size();
+
+    const size_t stride = max<size_t>(1, total / REJECTION_SAMPLE_POINTS);
+    vector<const float*> sample;
+    size_t seen = 0;
+    for (int c = 0; c < data.size(); c++) {
+        if (c == skipClass) continue;
+        for (const vector<float>& point : data[c]) {
+            if (seen++ % stride == 0)
+                sample.push_back(point.data());
+        }
+    }
+    return sample;
+}
+
+// bumps rejections[a] for every attribute a which, by itself, puts the point outside the block. same test as inside_HB.
+static void countRejections(const HyperBlock& h, int numAttributes, const float* point, vector<int>& rejections) {
+    constexpr float EPSILON = 1e-6f;
+    for (int i = 0; i < numAttributes; i++) {
+        bool inAnInterval = false;
+        for (int j = 0; j < h.maximums[i].size(); j++) {
+            if ((point[i] + EPSILON >= h.minimums[i][j]) && (point[i] - EPSILON <= h.maximums[i][j])) {
+                inAnInterval = true;
+                break;
+            }
+        }
+        if (!inAnInterval)
+            rejections[i]++;
+    }
+}
+
+// most rejections first. stable so ties keep index order.
+static vector<int> sortByRejections(const vector<int>& rejections) {
+    vector<int> order(rejections.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return rejections[a] > rejections[b]; });
+    return order;
+}
+
+void HyperBlock::orderChecksByRejection(const vector<const float*>& sample) {
+    const int numAttributes = maximums.size();
+    vector<int> rejections(numAttributes, 0);
+    for (const float* point : sample)
+        countRejections(*this, numAttributes, point, rejections);
+    checkOrder = sortByRejections(rejections);
+}
+
+vector<int> HyperBlock::rejectionOrder(const vector<HyperBlock>& blocks, const vector<vector<vector<float>>>& data, int classNum) {
+    const int numAttributes = data[0][0].size();
+
+    vector<const HyperBlock*> classBlocks;
+    for (const HyperBlock& h : blocks)
+        if (h.classNum == classNum) classBlocks.push_back(&h);
+
+    vector<int> rejections(numAttributes, 0);
+    const vector<const float*> sample = sampleRejectionPoints(data, classNum);
+    const size_t stride = max<size_t>(1, classBlocks.size() / REJECTION_SAMPLE_BLOCKS);
+    for (size_t b = 0; b < classBlocks.size(); b += stride)
+        for (const float* point : sample)
+            countRejections(*classBlocks[b], numAttributes, point, rejections);
+
+    return sortByRejections(rejections);
+}
+
 // Returns how many bounds the point was in.
 int HyperBlock::inside_N_Bounds(int numAttributes, const float* point) {
     constexpr float EPSILON = 1e-6f;
@@ -101,13 +180,13 @@ float HyperBlock::distance_to_HB_Edge(int numAttributes, const float* point) con
 /**
  * Calculate precision metrics for this specific HyperBlock based on validation data
  * Sets this->blockPrecision and populates this->precisionLostByClass
- * @param summaries Point summaries from validation run (blockId -> PointSummary mapping)
+ * @param summaries Point summaries from validation run
  * @param NUM_CLASSES Total number of classes in the problem
  * @param blockIdx The unique index id of this HyperBlock
  * @param useVotedResult If this is true, the algorithm should use the final prediction to not penalize blocks that were wrong but didn't result in bad classificatrion.
  * @return The precision of this HyperBlock (TP / (TP + FP))
  */
-void HyperBlock::setHBPrecisions(map<pair<int, int>, PointSummary> summaries, int NUM_CLASSES, bool useVotedResult) {
+void HyperBlock::setHBPrecisions(const PointSummaries& summaries, int NUM_CLASSES, bool useVotedResult) {
     // Initialize the precisionLostByClass vector
     this->precisionLostByClass.assign(NUM_CLASSES, 0.0f);
 
@@ -116,14 +195,15 @@ void HyperBlock::setHBPrecisions(map<pair<int, int>, PointSummary> summaries, in
     vector<int> FP_by_class(NUM_CLASSES, 0);  // Track FP by each class
 
     // Go through all point summaries to find points that fell into this block
-    for (const auto& entry : summaries) {
-        int actualClass = entry.first.first;
-        const auto& pointSummary = entry.second;
+    for (int n = 0; n < summaries.numPoints(); n++) {
+        if (summaries.predicted[n] == -1)
+            continue;
+        int actualClass = summaries.classOf(n);
 
         // Check if this point fell into our block
         bool pointInThisBlock = false;
-        for (const auto& blockInfo : pointSummary.blockHits) {
-            if (blockInfo.blockIdx == this->blockId) {
+        for (const BlockInfo* blockInfo = summaries.hitsBegin(n); blockInfo != summaries.hitsEnd(n); ++blockInfo) {
+            if (blockInfo->blockIdx == this->blockId) {
                 pointInThisBlock = true;
                 break;
             }
@@ -208,63 +288,92 @@ float HyperBlock::distance_to_HB_Combo(int numAttributes, const float* point) co
 
 
 /**
-* Previously this was just used to finmd the size of the hyperblock, but now we need to use it to find the average
-* point too. This should be done by adding all the points together and then at the end dividing each attribute by size.
-* this will allow for us to know where the "true" center of the block is.
-*/
-void HyperBlock::find_avg_and_size(const vector<vector<vector<float>>>& data) {
-    int totalSize = 0;
-    vector<float> sumPoint(data[0][0].size(), 0.0f); // Initialize sum vector with zeros
-    pointIndices.clear();
-    pointIndices.resize(data.size());
-
-    // Thread-local storage
+ * finds the size, average point and pointIndices of every block in the list, and sets their checkOrder. instead of every block going over all the data,
+ * every point gets tested against all the blocks at once through a BlockBoxes, and the hits get sorted out to their blocks after.
+ * each block's points get added up in class then point order, so the averages don't depend on how many threads there are.
+ */
+void HyperBlock::find_avg_and_size_all(vector<HyperBlock>& blocks, const vector<vector<vector<float>>>& data) {
+    if (blocks.empty())
+        return;
+
+    const int numAttributes = data[0][0].size();
+    const int numBlocks = blocks.size();
+
+    // every block gets ordered against the same sample, so it only gets picked once.
+    const vector<const float*> sample = sampleRejectionPoints(data, -1);
+    #pragma omp parallel for schedule(dynamic)
+    for (int b = 0; b < numBlocks; b++)
+        blocks[b].orderChecksByRejection(sample);
+
+    const BlockBoxes boxes(blocks, numAttributes);
+
+    // every point gets one number, class after class.
+    vector<int> classStart(data.size() + 1, 0);
+    for (int classIdx = 0; classIdx < data.size(); classIdx++)
+        classStart[classIdx + 1] = classStart[classIdx] + data[classIdx].size();
+    const int numPoints = classStart.back();
+
+    // (point, block) hits of each thread. static schedule hands every thread one run of points in order, so putting them together by thread keeps them in point order.
+    vector<vector<pair<int, int>>> threadHits(omp_get_max_threads());
     #pragma omp parallel
     {
-        vector<float> localSum(data[0][0].size(), 0.0f);
-        int localSize = 0;
-        vector<vector<int>> localIndices(data.size()); // Thread-local indices
-
-        #pragma omp for nowait
-        for (int classIdx = 0; classIdx < data.size(); classIdx++) {
-            for (int pointIdx = 0; pointIdx < data[classIdx].size(); pointIdx++) {
-                const auto& point = data[classIdx][pointIdx];
-                if (inside_HB(point.size(), point.data())) {
-                    localSize++;
-                    for (size_t j = 0; j < point.size(); j++) {
-                        localSum[j] += point[j];
-                    }
-                    localIndices[classIdx].push_back(pointIdx); // Track which point matched
-                }
-            }
+        vector<pair<int, int>> &hits = threadHits[omp_get_thread_num()];
+        BlockBoxes::Scratch scratch(boxes);
+        int classIdx = 0;
+
+        #pragma omp for schedule(static)
+        for (int p = 0; p < numPoints; p++) {
+            while (p >= classStart[classIdx + 1])
+                classIdx++;
+            const vector<float> &point = data[classIdx][p - classStart[classIdx]];
+            boxes.forEachContaining(point.data(), scratch, [&](int b) {
+                hits.emplace_back(p, b);
+                return true;
+            });
         }
+    }
 
-        // Merge thread-local results into shared variables
-        #pragma omp critical
-        {
-            totalSize += localSize;
-            for (size_t j = 0; j < sumPoint.size(); j++) {
-                sumPoint[j] += localSum[j];
-            }
-            for (int classIdx = 0; classIdx < data.size(); classIdx++) {
-                pointIndices[classIdx].insert(
-                    pointIndices[classIdx].end(),
-                    localIndices[classIdx].begin(),
-                    localIndices[classIdx].end()
-                );
-            }
+    // counting sort the hits by block, they stay in point order inside each block.
+    vector<int> blockStart(numBlocks + 1, 0);
+    for (const auto &hits : threadHits)
+        for (const auto &hit : hits)
+            blockStart[hit.second + 1]++;
+    for (int b = 0; b < numBlocks; b++)
+        blockStart[b + 1] += blockStart[b];
+
+    vector<int> blockPoints(blockStart.back());
+    vector<int> next(blockStart.begin(), blockStart.end() - 1);
+    for (const auto &hits : threadHits)
+        for (const auto &hit : hits)
+            blockPoints[next[hit.second]++] = hit.first;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int b = 0; b < numBlocks; b++) {
+        HyperBlock &hb = blocks[b];
+        vector<float> sumPoint(numAttributes, 0.0f);
+        hb.pointIndices.assign(data.size(), vector<int>());
+
+        int classIdx = 0;
+        for (int i = blockStart[b]; i < blockStart[b + 1]; i++) {
+            const int p = blockPoints[i];
+            while (p >= classStart[classIdx + 1])
+                classIdx++;
+            const vector<float> &point = data[classIdx][p - classStart[classIdx]];
+            for (int j = 0; j < numAttributes; j++)
+                sumPoint[j] += point[j];
+            hb.pointIndices[classIdx].push_back(p - classStart[classIdx]);
         }
-    }
 
-    // Compute average point
-    if (totalSize > 0) {
-        for (float& val : sumPoint) {
-            val /= totalSize;
+        const int totalSize = blockStart[b + 1] - blockStart[b];
+        if (totalSize > 0) {
+            for (float& val : sumPoint) {
+                val /= totalSize;
+            }
         }
-    }
 
-    this->size = totalSize;
-    this->avgPoint = sumPoint;
+        hb.size = totalSize;
+        hb.avgPoint = sumPoint;
+    }
 }
 
 void HyperBlock::tameBounds(const vector<vector<vector<float>>>& trainingData) {
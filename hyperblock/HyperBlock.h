@@ -54,6 +54,10 @@ public:
     // top and bottom pairs is the indexes which are top and bottom of the sorted list of dataATTR's in the interval and merging without cuda.
     std::vector<std::pair<int, int>> topBottomPairs; // first is bottom, second is top of interval
 
+    // the order inside_HB checks the attributes in, the ones which throw out the most points go first. empty means just 0..n-1.
+    // only changes how fast we find out a point is outside, never the answer. find_avg_and_size_all fills it in.
+    std::vector<int> checkOrder;
+
     // Constructor
     HyperBlock(const std::vector<std::vector<float>>& maxs, const std::vector<std::vector<float>>& mins, int cls);
     HyperBlock(std::vector<std::vector<std::vector<float>>>& hb_data, int cls);
@@ -62,12 +66,20 @@ public:
     float distance_to_HB_Combo(int numAttributes, const float* point) const;
     void tameBounds(const std::vector<std::vector<std::vector<float>>>& trainingData);
 
-    void setHBPrecisions(std::map<std::pair<int, int>, PointSummary> summaries, int NUM_CLASSES, bool voted = false);
+    void setHBPrecisions(const PointSummaries& summaries, int NUM_CLASSES, bool voted = false);
 
     bool inside_HB(int numAttributes, const float* point) const;
-    void find_avg_and_size(const std::vector<std::vector<std::vector<float>>>& data);
+    // size, average point and pointIndices of every block in the list, with one pass over the data instead of one per block. sets checkOrder too.
+    static void find_avg_and_size_all(std::vector<HyperBlock>& blocks, const std::vector<std::vector<std::vector<float>>>& data);
     int inside_N_Bounds(int numAttributes, const float* point);
 
+    // measures how often each attribute alone puts the sample points outside this block, and sets checkOrder from it.
+    void orderChecksByRejection(const std::vector<const float*>& sample);
+
+    // same idea for a whole class at once. samples the blocks of classNum against the other classes' points, and gives back the
+    // attributes sorted by how many points they reject, most first. used to lay out the flattened arrays for the merge and simplifications.
+    static std::vector<int> rejectionOrder(const std::vector<HyperBlock>& blocks, const std::vector<std::vector<std::vector<float>>>& data, int classNum);
+
 };
 
 #endif // HYPERBLOCK_H
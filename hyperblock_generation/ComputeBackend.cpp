@@ -0,0 +1,35 @@
+//
+// Created by Austin Snyder on 6/20/2025.
+//
+#include "ComputeBackend.h"
+#include "CpuBackend.h"
+#ifdef HYPERBLOCKS_ENABLE_CUDA
+#include "CudaBackend.h"
+#endif
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+static ComputeBackend* pickBackend() {
+#ifdef HYPERBLOCKS_ENABLE_CUDA
+    const char *forced = getenv("HYPERBLOCKS_BACKEND");
+    bool forceCPU = forced != nullptr && (strcmp(forced, "cpu") == 0 || strcmp(forced, "CPU") == 0);
+
+    if (!forceCPU && CudaBackend::deviceAvailable()) {
+        cout << "Using CUDA compute backend." << endl;
+        return new CudaBackend();
+    }
+    if (!forceCPU)
+        cout << "No CUDA device found, falling back to the CPU compute backend." << endl;
+#endif
+
+    cout << "Using CPU compute backend." << endl;
+    return new CpuBackend();
+}
+
+ComputeBackend& ComputeBackend::get() {
+    // picked once, lives for the whole program.
+    static ComputeBackend *backend = pickBackend();
+    return *backend;
+}
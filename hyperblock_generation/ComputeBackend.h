@@ -0,0 +1,76 @@
+//
+// Created by Austin Snyder on 6/20/2025.
+//
+#pragma once
+#include <vector>
+
+#ifndef COMPUTEBACKEND_H
+#define COMPUTEBACKEND_H
+
+// how many opposing points share one bounding box in the merge. one warp's worth, so on the GPU a warp takes a whole tile.
+#define OPPOSING_TILE_SIZE 32
+
+// most seeds we merge at once. the wave grows while seeds keep not merging and shrinks when they do.
+#define MAX_MERGE_WAVE 64
+
+// how many of the opposing points that blocked a candidate we remember. they get checked before the full scan next time.
+#define WITNESS_RING_SIZE 4
+
+/**
+ * The heavy lifting of the program (merging, removing useless blocks, removing useless attributes) goes through one of these.
+ * Everything in here takes plain host arrays in the same flattened layouts the kernels always used, so the code that builds those
+ * arrays (merger_cuda, Simplifications) doesn't care where it actually runs.
+ *
+ * CudaBackend: the kernels in MergerHyperBlock.cu. only exists when built with HYPERBLOCKS_ENABLE_CUDA.
+ * CpuBackend:  OpenMP versions of the same kernels, in MergerHyperBlockCPU.cpp.
+ *
+ * Use ComputeBackend::get() to grab whichever one this machine can run.
+ */
+class ComputeBackend {
+public:
+    virtual ~ComputeBackend() {}
+
+    // "CUDA" or "CPU", just for printing.
+    virtual const char* name() const = 0;
+
+    /**
+     * Merges all the blocks of one class together as much as possible. merger_cuda calls this for several classes at once from
+     * different OpenMP tasks, so it has to be safe to run concurrently on different arrays.
+     *
+     * @param mins, maxes        numBlocks * paddedLength bounds. padded attributes are -inf/+inf. updated in place. the attributes can be in
+     *                          any order (merger_cuda puts the best rejecting ones first), as long as the points and tiles use the same one.
+     * @param paddedLength       FIELD_LENGTH rounded up to a multiple of 4.
+     * @param opposingPoints     other class points in SoA float4 layout, chunk i of point p at [(i * numOpposingPoints + p) * 4]
+     * @param tileMins, tileMaxes bounding box of each run of OPPOSING_TILE_SIZE opposing points, paddedLength floats per tile like the block bounds.
+     * @param deleteFlags        numBlocks long, zeroed. comes back -1 for blocks that were merged into another block.
+     */
+    virtual void mergeBlocks(float *mins, float *maxes, int numBlocks, int paddedLength, const float *opposingPoints, int numOpposingPoints, const float *tileMins, const float *tileMaxes, int *deleteFlags) = 0;
+
+    /**
+     * The assign -> sum -> find better -> sum chain from removeUselessBlocks. Blocks are in the flattenMinsMaxesForRUB encoding.
+     * numPointsInBlocks comes back with how many points chose each block.
+     */
+    virtual void countPointsPerBlock(const float *dataPoints, int numAttributes, int numPoints, const float *blockMins, const float *blockMaxes, int minMaxLen, const int *blockEdges, int numBlocks, int *numPointsInBlocks) = 0;
+
+    /**
+     * Disjunction friendly attribute removal. blocks are in the flattenMinsMaxesForRUB encoding, dataset is row major from flattenDataset.
+     * attrRemoveFlags[block * fieldLen + attr] gets set to 1 for every attribute which can be removed.
+     * attributeOrder is the order we try removing attributes in, checkOrder the order we test a point's attributes in (HyperBlock::rejectionOrder),
+     * both numClasses * fieldLen. checkOrder only makes the point test quit sooner, it doesn't change what gets removed.
+     */
+    virtual void removeUselessAttributes(float *mins, float *maxes, const int *intervalCounts, int minMaxLen, const int *blockEdges, int numBlocks, const int *blockClasses, char *attrRemoveFlags, int fieldLen, const float *dataset, int numPoints, const int *classBorder, int numClasses, const int *attributeOrder, const int *checkOrder) = 0;
+
+    /**
+     * One interval per attribute version. blocks come from flatMinMaxNoEncode, dataset is row major from flattenDataset.
+     * removed attributes get set to [0, 1] directly in mins and maxes. attributeOrder and checkOrder same as above.
+     */
+    virtual void removeUselessAttributesNoDisjunctions(float *mins, float *maxes, int numBlocks, int fieldLen, const int *blockClasses, const float *dataset, int numPoints, const int *classBorder, int numClasses, const int *attributeOrder, const int *checkOrder) = 0;
+
+    /**
+     * Picks the backend once and hands back the same one every time after.
+     * CUDA if we were built with it and there is a device, CPU otherwise. setting HYPERBLOCKS_BACKEND=cpu forces the CPU one.
+     */
+    static ComputeBackend& get();
+};
+
+#endif //COMPUTEBACKEND_H
@@ -0,0 +1,91 @@
+//
+// Created by Austin Snyder on 6/20/2025.
+//
+#include "CpuBackend.h"
+#include "MergerHyperBlockCPU.h"
+#include <vector>
+#include <cstdio>
+#include <omp.h>
+using namespace std;
+
+// same loop merger_cuda always ran on the GPU, merge with a seed then rearrange the queue, but done a wave of seeds at a time.
+// the wave runs until the first seed that merged, that seed gets committed and rearranged, and the next wave starts right after it.
+// the merging itself is all OpenMP tasks. merger_cuda calls this from a task per class, so the classes share one pool of threads. if we get
+// called from outside a parallel region we just open one up ourselves.
+void CpuBackend::mergeBlocks(float *mins, float *maxes, int numBlocks, int paddedLength, const float *opposingPoints, int numOpposingPoints, const float *tileMins, const float *tileMaxes, int *deleteFlags) {
+
+    // one printf so the lines don't get chopped up when the classes print at the same time.
+    printf("Merging on CPU (%s, %d threads)\n", cpuMergerSimdLevel(), omp_in_parallel() ? omp_get_num_threads() : omp_get_max_threads());
+
+    if (!omp_in_parallel()) {
+        #pragma omp parallel
+        #pragma omp single
+        mergeClass(mins, maxes, numBlocks, paddedLength, opposingPoints, numOpposingPoints, tileMins, tileMaxes, deleteFlags);
+        return;
+    }
+    mergeClass(mins, maxes, numBlocks, paddedLength, opposingPoints, numOpposingPoints, tileMins, tileMaxes, deleteFlags);
+}
+
+void CpuBackend::mergeClass(float *mins, float *maxes, int numBlocks, int paddedLength, const float *opposingPoints, int numOpposingPoints, const float *tileMins, const float *tileMaxes, int *deleteFlags) {
+
+    vector<int> waveMergable((size_t)min(MAX_MERGE_WAVE, max(numBlocks, 1)) * numBlocks, 0);
+    vector<int> witnesses((size_t)numBlocks * WITNESS_RING_SIZE, -1);
+    vector<int> witnessHeads(numBlocks, 0);
+    vector<int> seedQueue(numBlocks);
+    vector<int> writeSeedQueue(numBlocks);
+    for (int i = 0; i < numBlocks; i++) {
+        seedQueue[i] = i;
+    }
+
+    int *readQueue = seedQueue.data();
+    int *writeQueue = writeSeedQueue.data();
+    int waveSize = 1;
+    for (int i = 0; i < numBlocks; ) {
+        const int thisWave = min(waveSize, numBlocks - i);
+
+        const int firstMerged = mergerHyperBlocksWaveCPU(i, thisWave, readQueue, numBlocks, paddedLength, numOpposingPoints, opposingPoints, tileMins, tileMaxes, mins, maxes, deleteFlags, waveMergable.data(), witnesses.data(), witnessHeads.data());
+        const bool merged = firstMerged < thisWave;
+        const int lastSlot = merged ? firstMerged : thisWave - 1;
+        int *slotMergable = &waveMergable[(size_t)lastSlot * numBlocks];
+
+        commitMergeWaveCPU(i, lastSlot, merged, readQueue, numBlocks, paddedLength, mins, maxes, deleteFlags, slotMergable);
+
+        // seeds that nobody ate leave the queue alone, so only the merged one needs the rearrange.
+        if (merged) {
+            rearrangeSeedQueueCPU(i + lastSlot, readQueue, writeQueue, slotMergable, numBlocks);
+            swap(readQueue, writeQueue);
+        }
+
+        i += lastSlot + 1;
+        waveSize = merged ? max(1, waveSize / 2) : min(MAX_MERGE_WAVE, waveSize * 2);
+    }
+}
+
+// ASSIGN -> SUM -> FIND BETTER -> SUM. minMaxLen is only for the device copies, the blockEdges are enough here.
+void CpuBackend::countPointsPerBlock(const float *dataPoints, int numAttributes, int numPoints, const float *blockMins, const float *blockMaxes, [[maybe_unused]] int minMaxLen, const int *blockEdges, int numBlocks, int *numPointsInBlocks) {
+    vector<int> dataPointBlocks(numPoints, -1);
+
+    // both walks only look at the blocks which could hold the point.
+    BlockStabbingIndex index;
+    index.build(dataPoints, numAttributes, numPoints, blockMins, blockMaxes, blockEdges, numBlocks);
+
+    fill(numPointsInBlocks, numPointsInBlocks + numBlocks, 0);
+    assignPointsToBlocksCPU(dataPoints, numAttributes, numPoints, blockMins, blockMaxes, blockEdges, numBlocks, index, dataPointBlocks.data());
+    sumPointsPerBlockCPU(dataPointBlocks.data(), numPoints, numPointsInBlocks);
+
+    findBetterBlocksCPU(dataPoints, numAttributes, numPoints, blockMins, blockMaxes, blockEdges, numBlocks, index, dataPointBlocks.data(), numPointsInBlocks);
+
+    // points found better homes, so recount.
+    fill(numPointsInBlocks, numPointsInBlocks + numBlocks, 0);
+    sumPointsPerBlockCPU(dataPointBlocks.data(), numPoints, numPointsInBlocks);
+}
+
+// checkOrder only orders the kernels' point loops. the CPU versions intersect sorted columns instead, so they don't have one.
+// minMaxLen is how much the kernels copy to the device, the blockEdges are enough here.
+void CpuBackend::removeUselessAttributes(float *mins, float *maxes, const int *intervalCounts, [[maybe_unused]] int minMaxLen, const int *blockEdges, int numBlocks, const int *blockClasses, char *attrRemoveFlags, int fieldLen, const float *dataset, int numPoints, const int *classBorder, int numClasses, const int *attributeOrder, [[maybe_unused]] const int *checkOrder) {
+    removeUselessAttributesCPU(mins, maxes, intervalCounts, blockEdges, numBlocks, blockClasses, attrRemoveFlags, fieldLen, dataset, numPoints, classBorder, numClasses, attributeOrder);
+}
+
+void CpuBackend::removeUselessAttributesNoDisjunctions(float *mins, float *maxes, int numBlocks, int fieldLen, const int *blockClasses, const float *dataset, int numPoints, const int *classBorder, int numClasses, const int *attributeOrder, [[maybe_unused]] const int *checkOrder) {
+    removeUselessAttributesNoDisjunctionsCPU(mins, maxes, numBlocks, fieldLen, blockClasses, dataset, numPoints, classBorder, numClasses, attributeOrder);
+}
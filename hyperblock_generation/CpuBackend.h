@@ -0,0 +1,27 @@
+//
+// Created by Austin Snyder on 6/20/2025.
+//
+#pragma once
+#include "ComputeBackend.h"
+
+#ifndef CPUBACKEND_H
+#define CPUBACKEND_H
+
+class CpuBackend : public ComputeBackend {
+public:
+    const char* name() const override { return "CPU"; }
+
+    void mergeBlocks(float *mins, float *maxes, int numBlocks, int paddedLength, const float *opposingPoints, int numOpposingPoints, const float *tileMins, const float *tileMaxes, int *deleteFlags) override;
+
+    void countPointsPerBlock(const float *dataPoints, int numAttributes, int numPoints, const float *blockMins, const float *blockMaxes, int minMaxLen, const int *blockEdges, int numBlocks, int *numPointsInBlocks) override;
+
+    void removeUselessAttributes(float *mins, float *maxes, const int *intervalCounts, int minMaxLen, const int *blockEdges, int numBlocks, const int *blockClasses, char *attrRemoveFlags, int fieldLen, const float *dataset, int numPoints, const int *classBorder, int numClasses, const int *attributeOrder, const int *checkOrder) override;
+
+    void removeUselessAttributesNoDisjunctions(float *mins, float *maxes, int numBlocks, int fieldLen, const int *blockClasses, const float *dataset, int numPoints, const int *classBorder, int numClasses, const int *attributeOrder, const int *checkOrder) override;
+
+private:
+    // the wave loop for one class. has to be called from inside a parallel region, the merging work goes out as tasks.
+    static void mergeClass(float *mins, float *maxes, int numBlocks, int paddedLength, const float *opposingPoints, int numOpposingPoints, const float *tileMins, const float *tileMaxes, int *deleteFlags);
+};
+
+#endif //CPUBACKEND_H
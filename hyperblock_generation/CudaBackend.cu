@@ -0,0 +1,363 @@
+//
+// Created by Austin Snyder on 6/20/2025.
+//
+#include "CudaBackend.h"
+#include "MergerHyperBlock.cuh"
+#include <vector>
+#include <iostream>
+#include <algorithm>
+using namespace std;
+
+bool CudaBackend::deviceAvailable() {
+    int deviceCount = 0;
+    cudaError_t err = cudaGetDeviceCount(&deviceCount);
+    if (err != cudaSuccess) {
+        // clear the sticky error so later cuda calls don't trip over it.
+        cudaGetLastError();
+        return false;
+    }
+    return deviceCount > 0;
+}
+
+// the loop that used to live in merger_cuda. used to be one launch of merge, rearrange and reset (and a sync after each) for every seed.
+// now it's done a wave of seeds at a time, the wave runs until the first seed that merged, that one gets committed and rearranged,
+// and the next wave starts right after it. the only round trip per wave is reading back which slot merged first.
+void CudaBackend::mergeBlocks(float *mins, float *maxes, int numBlocks, int paddedLength, const float *opposingPoints, int numOpposingPoints, const float *tileMins, const float *tileMaxes, int *deleteFlags) {
+
+    // Find best occupancy
+    int sharedMemSize = 2 * paddedLength * sizeof(float);
+    int minGridSize, blockSize;
+    cudaError_t err = cudaOccupancyMaxPotentialBlockSize(&minGridSize, &blockSize, mergerHyperBlocks, sharedMemSize, 0);
+    if (err != cudaSuccess) {
+        printf("CUDA error in cudaOccupancyMaxPotentialBlockSize: %s\n", cudaGetErrorString(err));
+        exit(-1);
+    }
+
+    // the kernel hands one tile to each warp, so the block has to be whole warps.
+    blockSize = max(OPPOSING_TILE_SIZE, (blockSize / OPPOSING_TILE_SIZE) * OPPOSING_TILE_SIZE);
+
+    // Compute grid size to cover all HBs. we already know our ideal block size from before.
+    int gridSize = (numBlocks + blockSize - 1) / blockSize;
+
+    // every class gets its own stream, merger_cuda runs the classes from different threads at the same time, so the
+    // kernels of one class can fill up the SMs another class's kernels leave empty. non blocking so it doesn't wait on the default stream.
+    cudaStream_t stream;
+    cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking);
+
+    int blockLengthFlattened = numBlocks * paddedLength;
+    size_t numOpposingFloats = (size_t)numOpposingPoints * paddedLength;
+    size_t numTileFloats = (size_t)((numOpposingPoints + OPPOSING_TILE_SIZE - 1) / OPPOSING_TILE_SIZE) * paddedLength;
+
+    // Allocate device memory for SoA float4 buffer
+    float4* d_points4 = nullptr;
+    cudaMalloc(&d_points4, numOpposingFloats * sizeof(float));
+    cudaMemcpyAsync(d_points4, opposingPoints, numOpposingFloats * sizeof(float), cudaMemcpyHostToDevice, stream);
+
+    // and the tile boxes that go with it
+    float *d_tileMins, *d_tileMaxes;
+    cudaMalloc(&d_tileMins, numTileFloats * sizeof(float));
+    cudaMalloc(&d_tileMaxes, numTileFloats * sizeof(float));
+    cudaMemcpyAsync(d_tileMins, tileMins, numTileFloats * sizeof(float), cudaMemcpyHostToDevice, stream);
+    cudaMemcpyAsync(d_tileMaxes, tileMaxes, numTileFloats * sizeof(float), cudaMemcpyHostToDevice, stream);
+
+    // Allocate device memory
+    float *d_hyperBlockMins, *d_hyperBlockMaxes;
+    int *d_deleteFlags, *d_waveMergable, *d_firstMergedSlot, *d_seedQueue, *d_writeSeedQueue;
+
+    cudaMalloc(&d_hyperBlockMins, blockLengthFlattened * sizeof(float));
+    cudaMalloc(&d_hyperBlockMaxes, blockLengthFlattened * sizeof(float));
+    cudaMalloc(&d_deleteFlags, numBlocks * sizeof(int));
+    cudaMemsetAsync(d_deleteFlags, 0, numBlocks * sizeof(int), stream);
+
+    vector<int> seedQueue(numBlocks);
+    for(int i = 0; i < numBlocks; i++){
+        seedQueue[i] = i;
+    }
+
+    size_t waveMergableLength = (size_t)min(MAX_MERGE_WAVE, max(numBlocks, 1)) * numBlocks;
+    cudaMalloc(&d_waveMergable, waveMergableLength * sizeof(int));
+    cudaMemsetAsync(d_waveMergable, 0, waveMergableLength * sizeof(int), stream);
+    cudaMalloc(&d_firstMergedSlot, sizeof(int));
+
+    // witness rings, all empty (-1 is all 0xFF bytes, so memset works).
+    int *d_witnesses, *d_witnessHeads;
+    cudaMalloc(&d_witnesses, (size_t)numBlocks * WITNESS_RING_SIZE * sizeof(int));
+    cudaMemsetAsync(d_witnesses, 0xFF, (size_t)numBlocks * WITNESS_RING_SIZE * sizeof(int), stream);
+    cudaMalloc(&d_witnessHeads, numBlocks * sizeof(int));
+    cudaMemsetAsync(d_witnessHeads, 0, numBlocks * sizeof(int), stream);
+    cudaMalloc(&d_seedQueue, numBlocks * sizeof(int));
+    cudaMalloc(&d_writeSeedQueue, numBlocks * sizeof(int));
+
+    // Copy data to device
+    cudaMemcpyAsync(d_hyperBlockMins, mins, blockLengthFlattened * sizeof(float), cudaMemcpyHostToDevice, stream);
+    cudaMemcpyAsync(d_hyperBlockMaxes, maxes, blockLengthFlattened * sizeof(float), cudaMemcpyHostToDevice, stream);
+    cudaMemcpyAsync(d_seedQueue, seedQueue.data(), numBlocks * sizeof(int), cudaMemcpyHostToDevice, stream);
+
+    int *readQueue = d_seedQueue;
+    int *writeQueue = d_writeSeedQueue;
+    int waveSize = 1;
+    for(int i = 0; i < numBlocks; ){
+        const int thisWave = min(waveSize, numBlocks - i);
+
+        cudaMemcpyAsync(d_firstMergedSlot, &thisWave, sizeof(int), cudaMemcpyHostToDevice, stream);
+        mergerHyperBlocksWrapper(
+            i, 			// first seednum
+            thisWave,   // seeds in this wave
+            readQueue,  // seedQueue
+            numBlocks,  // number seed blocks
+            paddedLength,	// num attributes
+            numOpposingPoints,	// num op class points
+            (float*)d_points4, // op class points
+            d_tileMins,                     // tile boxes
+            d_tileMaxes,
+            d_hyperBlockMins,				// mins
+            d_hyperBlockMaxes,				// maxes
+            d_deleteFlags,
+            d_waveMergable,					// mergable flags, one row per slot
+            d_firstMergedSlot,
+            d_witnesses,                    // blocking points from earlier attempts
+            d_witnessHeads,
+            gridSize,
+            blockSize,
+            sharedMemSize,
+            stream
+        );
+
+        // this is the one sync per wave, we need to know which slot merged first.
+        int firstMerged;
+        cudaMemcpyAsync(&firstMerged, d_firstMergedSlot, sizeof(int), cudaMemcpyDeviceToHost, stream);
+        cudaStreamSynchronize(stream);
+        const bool merged = firstMerged < thisWave;
+        const int lastSlot = merged ? firstMerged : thisWave - 1;
+        int *slotMergable = d_waveMergable + (size_t)lastSlot * numBlocks;
+
+        commitMergeWaveWrapper(i, lastSlot, merged, readQueue, numBlocks, paddedLength, d_hyperBlockMins, d_hyperBlockMaxes, d_deleteFlags, slotMergable, gridSize, blockSize, stream);
+
+        // seeds that nobody ate leave the queue alone, so only the merged one needs the rearrange.
+        if (merged) {
+            rearrangeSeedQueueWrapper(i + lastSlot, readQueue, writeQueue, d_deleteFlags, slotMergable, numBlocks, gridSize, blockSize, stream);
+            swap(readQueue, writeQueue);
+        }
+
+        i += lastSlot + 1;
+        waveSize = merged ? max(1, waveSize / 2) : min(MAX_MERGE_WAVE, waveSize * 2);
+    }
+
+    // Copy results back
+    cudaMemcpyAsync(mins, d_hyperBlockMins, blockLengthFlattened * sizeof(float), cudaMemcpyDeviceToHost, stream);
+    cudaMemcpyAsync(maxes, d_hyperBlockMaxes, blockLengthFlattened * sizeof(float), cudaMemcpyDeviceToHost, stream);
+    cudaMemcpyAsync(deleteFlags, d_deleteFlags, numBlocks * sizeof(int), cudaMemcpyDeviceToHost, stream);
+    cudaStreamSynchronize(stream);
+
+    // Free device memory
+    cudaFree(d_hyperBlockMins);
+    cudaFree(d_hyperBlockMaxes);
+    cudaFree(d_deleteFlags);
+    cudaFree(d_points4);
+    cudaFree(d_tileMins);
+    cudaFree(d_tileMaxes);
+    cudaFree(d_waveMergable);
+    cudaFree(d_firstMergedSlot);
+    cudaFree(d_witnesses);
+    cudaFree(d_witnessHeads);
+    cudaFree(d_seedQueue);
+    cudaFree(d_writeSeedQueue);
+    cudaStreamDestroy(stream);
+}
+
+// the four kernels from removeUselessBlocks. ASSIGN -> SUM -> FIND BETTER -> SUM.
+void CudaBackend::countPointsPerBlock(const float *dataPoints, int numAttributes, int numPoints, const float *blockMins, const float *blockMaxes, int minMaxLen, const int *blockEdges, int numBlocks, int *numPointsInBlocks) {
+
+    // Allocate device memory and copy data.
+    float *d_dataPointsArray, *d_blockMins, *d_blockMaxes;
+    int   *d_blockEdges;
+    int *d_dataPointBlocks, *d_numPointsInBlocks;
+
+    cudaMalloc((void**)&d_dataPointsArray, sizeof(float) * numPoints * numAttributes);
+    cudaMemcpy(d_dataPointsArray, dataPoints, sizeof(float) * numPoints * numAttributes, cudaMemcpyHostToDevice);
+
+    cudaMalloc((void**)&d_blockMins, sizeof(float) * minMaxLen);
+    cudaMemcpy(d_blockMins, blockMins, sizeof(float) * minMaxLen, cudaMemcpyHostToDevice);
+
+    cudaMalloc((void**)&d_blockMaxes, sizeof(float) * minMaxLen);
+    cudaMemcpy(d_blockMaxes, blockMaxes, sizeof(float) * minMaxLen, cudaMemcpyHostToDevice);
+
+    cudaMalloc((void**)&d_blockEdges, sizeof(int) * (numBlocks + 1));
+    cudaMemcpy(d_blockEdges, blockEdges, sizeof(int) * (numBlocks + 1), cudaMemcpyHostToDevice);
+
+    cudaMalloc((void**)&d_dataPointBlocks, sizeof(int) * numPoints);
+    cudaMemset(d_dataPointBlocks, 0, sizeof(int) * numPoints);
+
+    cudaMalloc((void**)&d_numPointsInBlocks, sizeof(int) * numBlocks);
+    cudaMemset(d_numPointsInBlocks, 0, sizeof(int) * numBlocks);
+
+    // Determine grid and block sizes using CUDA occupancy.
+    int minGridSize, blockSize;
+    cudaError_t err = cudaOccupancyMaxPotentialBlockSize(&minGridSize, &blockSize, assignPointsToBlocks, 0, 0);
+    if (err != cudaSuccess) {
+        printf("CUDA error in cudaOccupancyMaxPotentialBlockSize: %s\n", cudaGetErrorString(err));
+        exit(-1);
+    }
+    int gridSize = (numPoints + blockSize - 1) / blockSize;
+
+    assignPointsToBlocksWrapper(d_dataPointsArray, numAttributes, numPoints, d_blockMins, d_blockMaxes, d_blockEdges, numBlocks, d_dataPointBlocks, gridSize, blockSize);
+    cudaDeviceSynchronize();
+
+    sumPointsPerBlockWrapper(d_dataPointBlocks, numPoints, d_numPointsInBlocks, gridSize, blockSize);
+    cudaDeviceSynchronize();
+
+    findBetterBlocksWrapper(d_dataPointsArray, numAttributes, numPoints, d_blockMins, d_blockMaxes, d_blockEdges, numBlocks, d_dataPointBlocks, d_numPointsInBlocks, gridSize, blockSize);
+    cudaDeviceSynchronize();
+
+    // Reset the numPointsInBlocks array on the device, this is because we have now found better homes, and we are ready to recompute the sums.
+    cudaMemset(d_numPointsInBlocks, 0, sizeof(int) * numBlocks);
+    sumPointsPerBlockWrapper(d_dataPointBlocks, numPoints, d_numPointsInBlocks, gridSize, blockSize);
+    cudaDeviceSynchronize();
+
+    // Copy back the computed numPointsInBlocks.
+    cudaMemcpy(numPointsInBlocks, d_numPointsInBlocks, sizeof(int) * numBlocks, cudaMemcpyDeviceToHost);
+
+    // Free device memory.
+    cudaFree((void *)d_dataPointsArray);
+    cudaFree((void *)d_blockMins);
+    cudaFree((void *)d_blockMaxes);
+    cudaFree((void *)d_blockEdges);
+    cudaFree((void *)d_dataPointBlocks);
+    cudaFree((void *)d_numPointsInBlocks);
+}
+
+void CudaBackend::removeUselessAttributes(float *mins, float *maxes, const int *intervalCounts, int minMaxLen, const int *blockEdges, int numBlocks, const int *blockClasses, char *attrRemoveFlags, int fieldLen, const float *dataset, int numPoints, const int *classBorder, int numClasses, const int *attributeOrder, const int *checkOrder) {
+
+    // Device pointers.
+    float* d_mins = nullptr;
+    float* d_maxes = nullptr;
+    int* d_intervalCounts = nullptr;
+    int* d_blockEdges = nullptr;
+    int* d_blockClasses = nullptr;
+    char* d_attrRemoveFlags = nullptr;
+    float* d_dataset = nullptr;
+    int* d_classBorder = nullptr;
+    int *d_attributeOrderingsFlattened = nullptr;
+    int *d_checkOrders = nullptr;
+    int *d_attrOffsets = nullptr;
+
+    // Allocate device memory.
+    cudaMalloc((void**)&d_mins, minMaxLen * sizeof(float));
+    cudaMalloc((void**)&d_maxes, minMaxLen * sizeof(float));
+    cudaMalloc((void**)&d_intervalCounts, numBlocks * fieldLen * sizeof(int));
+    cudaMalloc((void**)&d_blockEdges, (numBlocks + 1) * sizeof(int));
+    cudaMalloc((void**)&d_blockClasses, numBlocks * sizeof(int));
+    cudaMalloc((void**)&d_attrRemoveFlags, numBlocks * fieldLen * sizeof(char));
+    cudaMalloc((void**)&d_dataset, (size_t)numPoints * fieldLen * sizeof(float));
+    cudaMalloc((void**)&d_classBorder, (numClasses + 1) * sizeof(int));
+    cudaMalloc((void**)&d_attributeOrderingsFlattened, numClasses * fieldLen * sizeof(int));
+    cudaMalloc((void**)&d_checkOrders, numClasses * fieldLen * sizeof(int));
+    cudaMalloc((void**)&d_attrOffsets, (size_t)numBlocks * fieldLen * sizeof(int));
+
+    // Copy host data to device.
+    cudaMemcpy(d_mins, mins, minMaxLen * sizeof(float), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_maxes, maxes, minMaxLen * sizeof(float), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_intervalCounts, intervalCounts, numBlocks * fieldLen * sizeof(int), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_blockEdges, blockEdges, (numBlocks + 1) * sizeof(int), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_blockClasses, blockClasses, numBlocks * sizeof(int), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_attrRemoveFlags, attrRemoveFlags, numBlocks * fieldLen * sizeof(char), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_dataset, dataset, (size_t)numPoints * fieldLen * sizeof(float), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_classBorder, classBorder, (numClasses + 1) * sizeof(int), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_attributeOrderingsFlattened, attributeOrder, numClasses * fieldLen * sizeof(int), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_checkOrders, checkOrder, numClasses * fieldLen * sizeof(int), cudaMemcpyHostToDevice);
+
+    // Determine execution configuration.
+    int blockSize;
+    int gridSize;
+
+    cudaOccupancyMaxPotentialBlockSize(&gridSize, &blockSize, removeUselessAttributes, 0, 0);
+    gridSize = (numBlocks + blockSize - 1) / blockSize;
+
+    // Launch the kernel.
+    removeUselessAttributesWrapper(d_mins, d_maxes, d_intervalCounts, minMaxLen, d_blockEdges, numBlocks, d_blockClasses, d_attrRemoveFlags, fieldLen, d_dataset, numPoints, d_classBorder, numClasses, d_attributeOrderingsFlattened, d_checkOrders, d_attrOffsets, gridSize, blockSize);
+    cudaDeviceSynchronize();
+
+    // Copy results from device back to host.
+    cudaMemcpy(attrRemoveFlags, d_attrRemoveFlags, numBlocks * fieldLen * sizeof(char), cudaMemcpyDeviceToHost);
+    cudaMemcpy(mins, d_mins, minMaxLen * sizeof(float), cudaMemcpyDeviceToHost);
+    cudaMemcpy(maxes, d_maxes, minMaxLen * sizeof(float), cudaMemcpyDeviceToHost);
+
+    // Free device memory.
+    cudaFree(d_mins);
+    cudaFree(d_maxes);
+    cudaFree(d_intervalCounts);
+    cudaFree(d_blockEdges);
+    cudaFree(d_blockClasses);
+    cudaFree(d_attrRemoveFlags);
+    cudaFree(d_dataset);
+    cudaFree(d_classBorder);
+    cudaFree(d_attributeOrderingsFlattened);
+    cudaFree(d_checkOrders);
+    cudaFree(d_attrOffsets);
+}
+
+void CudaBackend::removeUselessAttributesNoDisjunctions(float *mins, float *maxes, int numBlocks, int fieldLen, const int *blockClasses, const float *dataset, int numPoints, const int *classBorder, int numClasses, const int *attributeOrder, const int *checkOrder) {
+
+    // Transpose the dataset, from point being a row, to a point being a column. keeps the reads coalesced in the kernel.
+    vector<float> transposedData((size_t)numPoints * fieldLen);
+    for(int i = 0; i < numPoints; i++) {
+        for(int j = 0; j < fieldLen; j++) {
+            transposedData[(size_t)j * numPoints + i] = dataset[(size_t)i * fieldLen + j];
+        }
+    }
+
+    size_t boundsLen = (size_t)numBlocks * fieldLen;
+
+    // Device pointers.
+    float* d_mins = nullptr;
+    float* d_maxes = nullptr;
+    int* d_blockClasses = nullptr;
+    float* d_dataset = nullptr;
+    int* d_classBorder = nullptr;
+    int* d_attributeOrderingsFlattened = nullptr;
+    int* d_checkOrders = nullptr;
+
+    // Allocate device memory.
+    cudaMalloc((void**)&d_mins, boundsLen * sizeof(float));
+    cudaMalloc((void**)&d_maxes, boundsLen * sizeof(float));
+    cudaMalloc((void**)&d_blockClasses, numBlocks * sizeof(int));
+    cudaMalloc((void**)&d_dataset, transposedData.size() * sizeof(float));
+    cudaMalloc((void**)&d_classBorder, (numClasses + 1) * sizeof(int));
+    cudaMalloc((void**)&d_attributeOrderingsFlattened, numClasses * fieldLen * sizeof(int));
+    cudaMalloc((void**)&d_checkOrders, numClasses * fieldLen * sizeof(int));
+
+    // Copy host data to device.
+    cudaMemcpy(d_mins, mins, boundsLen * sizeof(float), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_maxes, maxes, boundsLen * sizeof(float), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_blockClasses, blockClasses, numBlocks * sizeof(int), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_dataset, transposedData.data(), transposedData.size() * sizeof(float), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_classBorder, classBorder, (numClasses + 1) * sizeof(int), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_attributeOrderingsFlattened, attributeOrder, numClasses * fieldLen * sizeof(int), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_checkOrders, checkOrder, numClasses * fieldLen * sizeof(int), cudaMemcpyHostToDevice);
+
+    // Determine execution configuration.
+    int blockSize;
+    int gridSize;
+    // bounds, then the class's check order.
+    int sharedMemSize = 2 * fieldLen * sizeof(float) + fieldLen * sizeof(int);
+
+    cudaOccupancyMaxPotentialBlockSize(&gridSize, &blockSize, removeUselessAttributesNoDisjunctions, sharedMemSize, 0);
+    gridSize = (numBlocks + blockSize - 1) / blockSize;
+
+    // Launch the kernel.
+    removeUselessAttributesNoDisjunctions<<<gridSize, blockSize, sharedMemSize>>>(d_mins, d_maxes, numBlocks, fieldLen, d_blockClasses, d_dataset, numPoints, d_classBorder, d_attributeOrderingsFlattened, d_checkOrders);
+    cudaDeviceSynchronize();
+
+    // Copy results from device back to host.
+    cudaMemcpy(mins, d_mins, boundsLen * sizeof(float), cudaMemcpyDeviceToHost);
+    cudaMemcpy(maxes, d_maxes, boundsLen * sizeof(float), cudaMemcpyDeviceToHost);
+
+    // Free device memory.
+    cudaFree(d_mins);
+    cudaFree(d_maxes);
+    cudaFree(d_blockClasses);
+    cudaFree(d_dataset);
+    cudaFree(d_classBorder);
+    cudaFree(d_attributeOrderingsFlattened);
+    cudaFree(d_checkOrders);
+}
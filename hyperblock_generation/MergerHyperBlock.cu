@@ -8,7 +8,7 @@
 // Hybrid kernel that uses block-level cooperation but vectorizes with float4's.
 // ------------------------------------------------------------------------------------------------
 // REFACTORED MERGER HYPER BLOCKS KERNEL FUNCTION. DOESN'T NEED THE COOPERATIVE GROUPS LIKE WE USE IN DV2.0.
-// WRAP IN A LOOP. launch mergerHyperBlocks with i up to N - 1 as seed index, each time then rearrange, then reset.
+// WRAP IN A LOOP. launch mergerHyperBlocks on a wave of seeds, commitMergeWave the slots up to the first one that merged, rearrange, next wave.
 // ------------------------------------------------------------------------------------------------
 
 // the monster. this is one of the heaviest parts of the whole program. it is very heavily optimized, so hard to read.
@@ -19,34 +19,42 @@
 // then we check THE ENTIRE DATASET to determine if other class points are inside our new bounds. if so, we don't update the bounds of our HB.
 // if there were no points inside, we can then do the merge, and we mark the seedblock as merged to, so it can die, and then we mark ours as merged.
 // if even one point merges to seed block, we know that we can delete it, since that block will be entirely inside of another one.
+//
+// it does a whole wave of seeds per launch, blockIdx.y is the slot, and slot s is the seed at readSeedQueue[firstSeedIndex + s].
+// nothing gets written to the bounds in here, just waveMergable[s * numBlocks + candidate], and firstMergedSlot gets the lowest slot that merged.
+// a seed nobody eats changes nothing, so the slots after it are still right. the first one that merges is right too, anything after that was
+// looking at stale bounds, so those slots bail out early and get redone in the next wave. commitMergeWave does the writing.
 __global__ void mergerHyperBlocks(
-    const int seedIndex, 
-    int *readSeedQueue, 
+    const int firstSeedIndex, 
+    const int waveSize,
+    const int *readSeedQueue, 
     const int numBlocks, 
     const int numAttributes,   // padded to be a multiple of 4 in calling function (merger_cuda() in interval_hyperblock.cu).
     const int numPoints, 
     const float *opposingPoints,
-    float *hyperBlockMins, 
-    float *hyperBlockMaxes,
-    int *deleteFlags, 
-    int *mergable
+    const float *tileMins,     // bounding box of each OPPOSING_TILE_SIZE run of opposing points, numAttributes floats per tile.
+    const float *tileMaxes,
+    const float *hyperBlockMins, 
+    const float *hyperBlockMaxes,
+    const int *deleteFlags, 
+    int *waveMergable,
+    int *firstMergedSlot,
+    int *witnesses,            // WITNESS_RING_SIZE opposing point indices per block that stopped it before, -1 for empty.
+    int *witnessHeads          // next spot to write in each block's ring.
 ) 
 {
     // Get our block and thread indices.
     const int blockIndex = blockIdx.x;
     const int localID = threadIdx.x;
+    const int slot = blockIdx.y;
 
     // Retrieve our seed block.
-    const int seedBlock = readSeedQueue[seedIndex];
-
-    // One thread per block sets initial flags for the seed block.
-    if (localID == 0) {
-        atomicMin(&deleteFlags[seedBlock], -9);
-        atomicMin(&mergable[seedBlock], -1);
-    }
+    const int seedBlock = readSeedQueue[firstSeedIndex + slot];
 
     // Shared flag to mark if the candidate merge remains possible.
     __shared__ int blockMergable;
+    // Shared flag for when an earlier slot already merged, and this whole slot is getting redone anyway.
+    __shared__ int slotStale;
     // Shared flags for early-out: did we actually change bounds vs. seed or candidate?
     __shared__ int usedSeedBlock;
     __shared__ int usedCandidateBlock;
@@ -76,14 +84,30 @@ __global__ void mergerHyperBlocks(
         if (candidate == seedBlock || deleteFlags[candidate] < 0)
             continue;
 
+        // seeds of the earlier slots are dead by the time this slot would have run, so they aren't candidates either.
+        bool earlierSeed = false;
+        for (int s = 0; s < slot; s++) {
+            if (readSeedQueue[firstSeedIndex + s] == candidate) {
+                earlierSeed = true;
+                break;
+            }
+        }
+        if (earlierSeed)
+            continue;
+
         // Reset our per-candidate flags.
         if (localID == 0) {
             blockMergable = 1;      // assume merge is allowed initially
             usedSeedBlock = 0;      // will be set if seed's values are not solely used
             usedCandidateBlock = 0; // will be set if candidate's values are not solely used
+            slotStale = *((volatile int*)firstMergedSlot) < slot;
         }
         __syncthreads();
 
+        // an earlier slot already merged, this one gets redone in the next wave.
+        if (slotStale)
+            break;
+
         // (a) build combined bounds into shared memory
         for (int i = localID; i < numAttributesAsFours; i += blockDim.x) {
             // Load seed block's bounds.
@@ -125,9 +149,68 @@ __global__ void mergerHyperBlocks(
         // Determine whether we really need to scan the dataset.
         int needDatasetCheck = (usedSeedBlock && usedCandidateBlock);
 
+        // (b) before the scan, check the points which stopped this candidate before. the bounds only grow, so they tend to still be inside,
+        // and then a failing merge is over after a few compares. one thread per witness.
+        if (needDatasetCheck && localID < WITNESS_RING_SIZE) {
+            int witness = witnesses[candidate * WITNESS_RING_SIZE + localID];
+            if (witness >= 0) {
+                bool pointOutside = false;
+                for (int i = 0; i < numAttributesAsFours; i++) {
+                    float4 pointVal = opp4[ i * numPoints + witness ];
+                    float4 combMin  = localCombinedMins[i];
+                    float4 combMax  = localCombinedMaxes[i];
+                    if (pointVal.x < combMin.x || pointVal.x > combMax.x ||
+                        pointVal.y < combMin.y || pointVal.y > combMax.y ||
+                        pointVal.z < combMin.z || pointVal.z > combMax.z ||
+                        pointVal.w < combMin.w || pointVal.w > combMax.w) {
+                        pointOutside = true;
+                        break;
+                    }
+                }
+                if (!pointOutside) {
+                    blockMergable = 0;
+                }
+            }
+        }
+        __syncthreads();
+
         // check the entire dataset now. we have transposed our point matrix, so that threads are working on adjacent elements.
         // this is a small change which gives big speedup. having threads 0 and 1 reading elements 0 and 1, instead of 0 and (numAttributes + 1) is a huge speed gain.
-        for (int pointIndex = localID; pointIndex < numPoints && blockMergable && needDatasetCheck; pointIndex += blockDim.x) {
+        // the points are in Morton order and grouped into tiles of OPPOSING_TILE_SIZE (one warp). each warp takes a tile, checks the tile's box against
+        // the combined bounds with the lanes splitting the attributes, and only if the box overlaps does each lane check its one point.
+        const int lane = localID & (OPPOSING_TILE_SIZE - 1);
+        const int warpID = localID / OPPOSING_TILE_SIZE;
+        const int numWarps = blockDim.x / OPPOSING_TILE_SIZE;
+        const int numTiles = (numPoints + OPPOSING_TILE_SIZE - 1) / OPPOSING_TILE_SIZE;
+        for (int tile = warpID; tile < numTiles && needDatasetCheck; tile += numWarps) {
+            // everyone in the warp has to agree on whether to keep going, or the shuffles below would hang.
+            if (!__shfl_sync(0xFFFFFFFF, blockMergable, 0))
+                break;
+
+            const float4 *tileMin4 = (const float4*)&tileMins[tile * numAttributes];
+            const float4 *tileMax4 = (const float4*)&tileMaxes[tile * numAttributes];
+            int missesBlock = 0;
+            for (int i = lane; i < numAttributesAsFours; i += OPPOSING_TILE_SIZE) {
+                float4 tMin = tileMin4[i];
+                float4 tMax = tileMax4[i];
+                float4 combMin = localCombinedMins[i];
+                float4 combMax = localCombinedMaxes[i];
+                if (tMax.x < combMin.x || tMin.x > combMax.x ||
+                    tMax.y < combMin.y || tMin.y > combMax.y ||
+                    tMax.z < combMin.z || tMin.z > combMax.z ||
+                    tMax.w < combMin.w || tMin.w > combMax.w) {
+                    missesBlock = 1;
+                    break;
+                }
+            }
+            // the whole tile is outside, one box test and we skip OPPOSING_TILE_SIZE points.
+            if (__any_sync(0xFFFFFFFF, missesBlock))
+                continue;
+
+            const int pointIndex = tile * OPPOSING_TILE_SIZE + lane;
+            if (pointIndex >= numPoints)
+                continue;
+
             bool pointOutside = false;
             for (int i = 0; i < numAttributesAsFours; i++) {
                 // coalesced SoA load:
@@ -144,31 +227,59 @@ __global__ void mergerHyperBlocks(
             }
             if (!pointOutside) {
                 blockMergable = 0;
-                break;
+
+                // remember who stopped us for next time.
+                unsigned int head = atomicAdd((unsigned int*)&witnessHeads[candidate], 1u);
+                witnesses[candidate * WITNESS_RING_SIZE + head % WITNESS_RING_SIZE] = pointIndex;
             }
         }
         __syncthreads();
 
-        // (c) write back result for this candidate
-        if (blockMergable) {
-            // if the block was mergeable, we are just going to save it's new combined bounds
-            for (int i = localID; i < numAttributesAsFours; i += blockDim.x) {
-                *((float4*)&hyperBlockMins[candidate * numAttributes] + i) = localCombinedMins[i];
-                *((float4*)&hyperBlockMaxes[candidate * numAttributes] + i) = localCombinedMaxes[i];
-            }
-
-            // now thread 0 can mark the seedblock as deleteable, and we are merged.
-            if (localID == 0) {
-                atomicMax(&deleteFlags[seedBlock], -1);
-                mergable[candidate] = 1;
-            }
-        } else if (localID == 0) {
-            mergable[candidate] = 0;
+        // (c) write back result for this candidate. the bounds get written by commitMergeWave, if this slot is the one we keep.
+        if (localID == 0) {
+            waveMergable[slot * numBlocks + candidate] = blockMergable ? 1 : 0;
+            if (blockMergable)
+                atomicMin(firstMergedSlot, slot);
         }
         __syncthreads();
     }
 }
 
+// keeps slots [0, lastSlot] of the wave. their seeds die (-9), if lastSlot merged its seed is -1 instead, and every candidate which ate it takes
+// the combined bounds. only candidates after the seed in the queue can have merged, so one thread per queue position.
+__global__ void commitMergeWave(const int firstSeedIndex, const int lastSlot, const int lastSlotMerged, const int *readSeedQueue, const int numBlocks, const int numAttributes, float *hyperBlockMins, float *hyperBlockMaxes, int *deleteFlags, const int *slotMergable){
+
+    const int numAttributesAsFours = numAttributes / 4;
+    const int lastSeedPos = firstSeedIndex + lastSlot;
+    const int seedBlock = readSeedQueue[lastSeedPos];
+
+    for (int q = blockIdx.x * blockDim.x + threadIdx.x; q < numBlocks; q += gridDim.x * blockDim.x) {
+        if (q < firstSeedIndex)
+            continue;
+
+        if (q <= lastSeedPos) {
+            const int seed = readSeedQueue[q];
+            deleteFlags[seed] = min(deleteFlags[seed], -9);
+            if (q == lastSeedPos && lastSlotMerged)
+                deleteFlags[seed] = max(deleteFlags[seed], -1);
+            continue;
+        }
+
+        const int candidate = readSeedQueue[q];
+        if (!lastSlotMerged || slotMergable[candidate] != 1)
+            continue;
+
+        for (int i = 0; i < numAttributesAsFours; i++) {
+            float4 seedMin = *((float4*)&hyperBlockMins[seedBlock * numAttributes] + i);
+            float4 seedMax = *((float4*)&hyperBlockMaxes[seedBlock * numAttributes] + i);
+            float4 *candMin = (float4*)&hyperBlockMins[candidate * numAttributes] + i;
+            float4 *candMax = (float4*)&hyperBlockMaxes[candidate * numAttributes] + i;
+            *candMin = make_float4(min_f(seedMin.x, candMin->x), min_f(seedMin.y, candMin->y), min_f(seedMin.z, candMin->z), min_f(seedMin.w, candMin->w));
+            *candMax = make_float4(max_f(seedMax.x, candMax->x), max_f(seedMax.y, candMax->y), max_f(seedMax.z, candMax->z), max_f(seedMax.w, candMax->w));
+        }
+    }
+}
+
 
 // rearrange seed queue is important. we run this right after the merging has happened. so we run the merge for one particular seed block. then we rearrange.
 // the HBs which merged go to the back, and the ones which didn't slide to the front. notice how if block deadSeedNum + 1 merged, it would actually end up at the back. that's
@@ -402,8 +513,11 @@ __global__ void findBetterBlocks(const float *dataPointsArray, const int numAttr
  * FOR EXAMPLE: RIGHT NOW THIS IS DISJUNCTION FRIENDLY, BUT THAT MEANS WE DO ALL THIS GARBAGE WITH COUNTING INTERVALS AND BLOCK START AND SO ON.
  * IF YOU JUST MADE A VERSION WHICH ONLY WORKS ON REGULAR HBS, IT WOULD BE WAY MORE EFFICIENT. YOU MIGHT BE ABLE TO SIMPLIFY FULL_MNIST EASILY. (especially on 10 lab computers like we did.)
  * it could be hyper optimized in the future as we did with the merging. but this version runs "good enough" for anything but mnist set.
+ *
+ * the point test goes through the attributes in checkOrder (per class, most rejecting first) instead of 0..n-1, since the first attribute
+ * which throws the point out ends the test. attrOffsets is numBlocks * fieldLen scratch, each thread fills in where its block's attributes start.
  */
-__global__ void removeUselessAttributes(float* mins, float* maxes, const int* intervalCounts, const int minMaxLen, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder) {
+__global__ void removeUselessAttributes(float* mins, float* maxes, const int* intervalCounts, const int minMaxLen, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder, const int *checkOrder, int *attrOffsets) {
 
     int threadID = blockIdx.x * blockDim.x + threadIdx.x;
     if(threadID >= numBlocks) return;
@@ -413,6 +527,15 @@ __global__ void removeUselessAttributes(float* mins, float* maxes, const int* in
     float* blockMaxes = &maxes[blockEdges[threadID]];
     const int* blockIntervalCounts = &intervalCounts[threadID * fieldLen];
     int classNum = blockClasses[threadID];
+    const int* classCheckOrder = &checkOrder[fieldLen * classNum];
+
+    // where each attribute's intervals start. each attribute has its interval count stored in front of it, so skip those too.
+    int* blockAttrOffsets = &attrOffsets[threadID * fieldLen];
+    int runningOffset = 1;
+    for(int a = 0; a < fieldLen; a++) {
+        blockAttrOffsets[a] = runningOffset;
+        runningOffset += blockIntervalCounts[a] + 1;
+    }
 
     // Class boundaries
     const int startClass = classBorder[classNum] * fieldLen;
@@ -423,11 +546,7 @@ __global__ void removeUselessAttributes(float* mins, float* maxes, const int* in
         // we are using the attribute order with different orderings per class. therefore, we must offset into our own class.
         int removed = attributeOrder[fieldLen * classNum + removedIndex];
 
-        // Calculate offset to the start of this attribute's intervals
-        int checkOffset = 0;
-        for(int i = 0; i < removed; i++) {
-            checkOffset += blockIntervalCounts[i];
-        }
+        int checkOffset = blockAttrOffsets[removed];
 
         // Skip if this attribute is already marked as removed (checking first interval)
         if(blockMins[checkOffset] == 0.0 && blockMaxes[checkOffset] == 1.0) {
@@ -440,15 +559,13 @@ __global__ void removeUselessAttributes(float* mins, float* maxes, const int* in
             if(j < endClass && j >= startClass) continue;
 
             bool pointInside = true;
-            int totalOffset = 0;
 
-            // Check each attribute
-            for(int attr = 0; attr < fieldLen; attr++) {
-                if(attr == removed) {
-                    totalOffset += blockIntervalCounts[attr];
-                    continue;
-                }
+            // Check each attribute, best rejectors first
+            for(int k = 0; k < fieldLen; k++) {
+                const int attr = classCheckOrder[k];
+                if(attr == removed) continue;
 
+                const int totalOffset = blockAttrOffsets[attr];
                 const float attrValue = dataset[j + attr];
                 bool inAnInterval = false;
 
@@ -466,8 +583,6 @@ __global__ void removeUselessAttributes(float* mins, float* maxes, const int* in
                     pointInside = false;
                     break;
                 }
-
-                totalOffset += blockIntervalCounts[attr];
             }
 
             if(pointInside) {
@@ -478,15 +593,10 @@ __global__ void removeUselessAttributes(float* mins, float* maxes, const int* in
 
         // If no points from other classes fall in, we can remove this attribute
         if(!someOneInBounds) {
-            int removeOffset = 0;
-            for(int i = 0; i < removed; i++) {
-                removeOffset += blockIntervalCounts[i];
-            }
-
             // Reset intervals for removed attribute to [0,1]
             for(int i = 0; i < blockIntervalCounts[removed]; i++) {
-                blockMins[removeOffset + i] = 0.0;
-                blockMaxes[removeOffset + i] = 1.0;
+                blockMins[checkOffset + i] = 0.0;
+                blockMaxes[checkOffset + i] = 1.0;
             }
 
             // Mark attribute as removed
@@ -507,7 +617,8 @@ __global__ void removeUselessAttributesNoDisjunctions(
     const float *__restrict__ dataset,
     const int numPoints,
     const int *classBorder,
-    const int *attributeOrder)
+    const int *attributeOrder,
+    const int *checkOrder)
 {
     int blockID  = blockIdx.x;
     int threadID = threadIdx.x;
@@ -516,6 +627,7 @@ __global__ void removeUselessAttributesNoDisjunctions(
     extern __shared__ float hyperBlockBounds[];
     float *blockMins  = hyperBlockBounds;
     float *blockMaxes = hyperBlockBounds + FIELD_LENGTH;
+    int *classCheckOrder = (int *)(hyperBlockBounds + 2 * FIELD_LENGTH);   // the order we test a point's attributes in, most rejecting first
 
     // shared scalars
     __shared__ int classNum, classStart, classEnd;
@@ -540,6 +652,10 @@ __global__ void removeUselessAttributesNoDisjunctions(
             classEnd   = classBorder[classNum + 1];
         }
         __syncthreads();
+        for (int i = threadID; i < FIELD_LENGTH; i += blockDim.x) {
+            classCheckOrder[i] = checkOrder[classNum * FIELD_LENGTH + i];
+        }
+        __syncthreads();
 
         /* Test every attribute for removability ----------------------- */
         for (int attrIdx = 0; attrIdx < FIELD_LENGTH; ++attrIdx) {
@@ -563,7 +679,8 @@ __global__ void removeUselessAttributesNoDisjunctions(
                 if (attrRemovableWarp == 0) break;
 
                 bool inBounds = true;
-                for (int a = 0; a < FIELD_LENGTH; ++a) {
+                for (int k = 0; k < FIELD_LENGTH; ++k) {
+                    const int a = classCheckOrder[k];
                     // skip the attribute we are “removing”
                     if (a == attributeToRemove) continue;
 
@@ -606,28 +723,38 @@ __global__ void removeUselessAttributesNoDisjunctions(
 }
 
 
-void mergerHyperBlocksWrapper(const int seedIndex, int *readSeedQueue, const int numBlocks, const int numAttributes, const int numPoints, const float *opposingPoints,float *hyperBlockMins, float *hyperBlockMaxes, int *deleteFlags, int *mergable, int gridSize, int blockSize, int sharedMemSize){
-	mergerHyperBlocks<<<gridSize, blockSize, sharedMemSize>>>(
-            seedIndex,
+void mergerHyperBlocksWrapper(const int firstSeedIndex, const int waveSize, const int *readSeedQueue, const int numBlocks, const int numAttributes, const int numPoints, const float *opposingPoints, const float *tileMins, const float *tileMaxes, const float *hyperBlockMins, const float *hyperBlockMaxes, const int *deleteFlags, int *waveMergable, int *firstMergedSlot, int *witnesses, int *witnessHeads, int gridSize, int blockSize, int sharedMemSize, cudaStream_t stream){
+	mergerHyperBlocks<<<dim3(gridSize, waveSize), blockSize, sharedMemSize, stream>>>(
+            firstSeedIndex,
+            waveSize,
             readSeedQueue,
             numBlocks,
             numAttributes,
             numPoints,
             opposingPoints,
+            tileMins,
+            tileMaxes,
 	    	hyperBlockMins,
 			hyperBlockMaxes,
 			deleteFlags,
-			mergable
+			waveMergable,
+			firstMergedSlot,
+			witnesses,
+			witnessHeads
 		);
 }
 
-void rearrangeSeedQueueWrapper(const int deadSeedCount, int *readSeedQueue, int *writeSeedQueue, int *deleteFlags, int *mergable, const int numBlocks, int gridSize, int blockSize){
-    rearrangeSeedQueue<<<gridSize, blockSize>>>(deadSeedCount, readSeedQueue, writeSeedQueue, deleteFlags, mergable, numBlocks);
+void rearrangeSeedQueueWrapper(const int deadSeedCount, int *readSeedQueue, int *writeSeedQueue, int *deleteFlags, int *mergable, const int numBlocks, int gridSize, int blockSize, cudaStream_t stream){
+    rearrangeSeedQueue<<<gridSize, blockSize, 0, stream>>>(deadSeedCount, readSeedQueue, writeSeedQueue, deleteFlags, mergable, numBlocks);
 }
 void resetMergableFlagsWrapper(int *mergableFlags, const int numBlocks, int gridSize, int blockSize){
 	resetMergableFlags<<<gridSize, blockSize>>>(mergableFlags, numBlocks);
 }
 
+void commitMergeWaveWrapper(const int firstSeedIndex, const int lastSlot, const int lastSlotMerged, const int *readSeedQueue, const int numBlocks, const int numAttributes, float *hyperBlockMins, float *hyperBlockMaxes, int *deleteFlags, const int *slotMergable, int gridSize, int blockSize, cudaStream_t stream){
+	commitMergeWave<<<gridSize, blockSize, 0, stream>>>(firstSeedIndex, lastSlot, lastSlotMerged, readSeedQueue, numBlocks, numAttributes, hyperBlockMins, hyperBlockMaxes, deleteFlags, slotMergable);
+}
+
 /**
 * --------------- wrapper functions to run the removing useless blocks functionality.
 */
@@ -647,6 +774,6 @@ void findBetterBlocksWrapper(const float *dataPointsArray, const int numAttribut
  * Wrapper functions for the removing useless attributes.
  * */
 
-void removeUselessAttributesWrapper(float* mins, float* maxes, const int* intervalCounts, const int minMaxLen, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder, int gridSize, int blockSize){
-   removeUselessAttributes<<<gridSize, blockSize>>>(mins, maxes, intervalCounts, minMaxLen, blockEdges, numBlocks, blockClasses, attrRemoveFlags, fieldLen, dataset, numPoints, classBorder, numClasses, attributeOrder);
+void removeUselessAttributesWrapper(float* mins, float* maxes, const int* intervalCounts, const int minMaxLen, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder, const int *checkOrder, int *attrOffsets, int gridSize, int blockSize){
+   removeUselessAttributes<<<gridSize, blockSize>>>(mins, maxes, intervalCounts, minMaxLen, blockEdges, numBlocks, blockClasses, attrRemoveFlags, fieldLen, dataset, numPoints, classBorder, numClasses, attributeOrder, checkOrder, attrOffsets);
 }
\ No newline at end of file
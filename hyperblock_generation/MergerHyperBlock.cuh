@@ -1,6 +1,7 @@
 #pragma once
 #include <cuda_runtime.h>
 #include "../hyperblock/HyperBlock.h"
+#include "ComputeBackend.h"
 #include <stdio.h>
 #include <limits>
 
@@ -8,9 +9,13 @@
 #define HyperBlockCuda_CUH
 // === KERNELS: ===
 __global__ void mergerHyperBlocks(
-    const int seedIndex, int *readSeedQueue, const int numBlocks,
+    const int firstSeedIndex, const int waveSize, const int *readSeedQueue, const int numBlocks,
     const int numAttributes, const int numPoints, const float *opposingPoints,
-    float *hyperBlockMins, float *hyperBlockMaxes, int *deleteFlags, int *mergable);
+    const float *tileMins, const float *tileMaxes,
+    const float *hyperBlockMins, const float *hyperBlockMaxes, const int *deleteFlags, int *waveMergable, int *firstMergedSlot,
+    int *witnesses, int *witnessHeads);
+
+__global__ void commitMergeWave(const int firstSeedIndex, const int lastSlot, const int lastSlotMerged, const int *readSeedQueue, const int numBlocks, const int numAttributes, float *hyperBlockMins, float *hyperBlockMaxes, int *deleteFlags, const int *slotMergable);
 
 __global__ void rearrangeSeedQueue(
     int *readSeedQueue, int *writeSeedQueue, int *deleteFlags,int *mergable, const int numBlocks);
@@ -27,11 +32,15 @@ __global__ void assignPointsToBlocks(
 // === WRAPPERS: USE THESE TO CALL THE KERNELS FROM A CPP FILE!  ===
 // ------------------------ creating hyperblocks wrapper functions --------------------------------
 void mergerHyperBlocksWrapper(
-    const int seedIndex, int *readSeedQueue, const int numBlocks,
+    const int firstSeedIndex, const int waveSize, const int *readSeedQueue, const int numBlocks,
     const int numAttributes, const int numPoints, const float *opposingPoints,
-    float *hyperBlockMins, float *hyperBlockMaxes, int *deleteFlags, int *mergable, int gridSize, int blockSize, int sharedMemSize);
+    const float *tileMins, const float *tileMaxes,
+    const float *hyperBlockMins, const float *hyperBlockMaxes, const int *deleteFlags, int *waveMergable, int *firstMergedSlot,
+    int *witnesses, int *witnessHeads, int gridSize, int blockSize, int sharedMemSize, cudaStream_t stream = 0);
+
+void commitMergeWaveWrapper(const int firstSeedIndex, const int lastSlot, const int lastSlotMerged, const int *readSeedQueue, const int numBlocks, const int numAttributes, float *hyperBlockMins, float *hyperBlockMaxes, int *deleteFlags, const int *slotMergable, int gridSize, int blockSize, cudaStream_t stream = 0);
 
-void rearrangeSeedQueueWrapper(const int deadSeedNum, int *readSeedQueue, int *writeSeedQueue, int *deleteFlags,int *mergable, const int numBlocks, int gridSize, int blockSize);
+void rearrangeSeedQueueWrapper(const int deadSeedNum, int *readSeedQueue, int *writeSeedQueue, int *deleteFlags,int *mergable, const int numBlocks, int gridSize, int blockSize, cudaStream_t stream = 0);
 
 void resetMergableFlagsWrapper(int *mergableFlags, const int numBlocks, int gridSize, int blockSize);
 
@@ -44,8 +53,10 @@ void sumPointsPerBlockWrapper(int *dataPointBlocks, const int numPoints, int *nu
 
 void findBetterBlocksWrapper(const float *dataPointsArray, const int numAttributes, const int numPoints, const float *blockMins, const float *blockMaxes, const int *blockEdges, const int numBlocks, int *dataPointBlocks, int *numPointsInBlocks, int gridSize, int blockSize);
 
-__global__ void removeUselessAttributes(float* mins, float* maxes, const int* intervalCounts, const int minMaxLen, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder);
+void removeUselessAttributesWrapper(float* mins, float* maxes, const int* intervalCounts, const int minMaxLen, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder, const int *checkOrder, int *attrOffsets, int gridSize, int blockSize);
+
+__global__ void removeUselessAttributes(float* mins, float* maxes, const int* intervalCounts, const int minMaxLen, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder, const int *checkOrder, int *attrOffsets);
 // same as above version, but this one assumes that the HBs are only one rule per attribute. so we can use a lot more efficient methods.
 // makes changes to block bounds directly in the kernel, no need for the dumb flags.
-__global__ void removeUselessAttributesNoDisjunctions(float *mins, float *maxes, const int numBlocks, const int FIELD_LENGTH, const int *blockClasses, const float *dataset, const int numPoints, const int *classBorder, const int *attributeOrder);
+__global__ void removeUselessAttributesNoDisjunctions(float *mins, float *maxes, const int numBlocks, const int FIELD_LENGTH, const int *blockClasses, const float *dataset, const int numPoints, const int *classBorder, const int *attributeOrder, const int *checkOrder);
 #endif
\ No newline at end of file
@@ -0,0 +1,1073 @@
+//
+// Created by Austin Snyder on 6/18/2025.
+//
+#include "MergerHyperBlockCPU.h"
+#include "ComputeBackend.h"
+#include "../interval_hyperblock/IntervalHyperBlock.h"
+#include <cstring>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <omp.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HB_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// checks the points [start, end) against the combined bounds. returns the first point which is fully inside, or -1 if none are.
+// padded attributes have -inf points and -inf/+inf bounds, so they never push a point outside.
+static int anyPointInsideScalar(const float *opp, const int numPoints, const int numChunks, int start, const int end, const float *combMins, const float *combMaxes) {
+    for (int p = start; p < end; p++) {
+        bool pointOutside = false;
+        for (int i = 0; i < numChunks && !pointOutside; i++) {
+            const float *v = &opp[((size_t)i * numPoints + p) * 4];
+            const float *mn = &combMins[i * 4];
+            const float *mx = &combMaxes[i * 4];
+            if (v[0] < mn[0] || v[0] > mx[0] ||
+                v[1] < mn[1] || v[1] > mx[1] ||
+                v[2] < mn[2] || v[2] > mx[2] ||
+                v[3] < mn[3] || v[3] > mx[3]) {
+                pointOutside = true;
+            }
+        }
+        if (!pointOutside)
+            return p;
+    }
+    return -1;
+}
+
+#ifdef HB_X86_SIMD
+// AVX2 version. since the points are SoA by float4 chunks, points p and p + 1 are next to each other for the same chunk,
+// so one 256 bit load gets a chunk of 2 points. we keep a mask of which lanes went outside, and quit on the pair once both are out.
+__attribute__((target("avx2")))
+static int anyPointInsideAVX2(const float *opp, const int numPoints, const int numChunks, int start, const int end, const float *combMins, const float *combMaxes) {
+    int p = start;
+    for (; p + 2 <= end; p += 2) {
+        int outside = 0;
+        for (int i = 0; i < numChunks; i++) {
+            __m256 v = _mm256_loadu_ps(&opp[((size_t)i * numPoints + p) * 4]);
+            __m256 mn = _mm256_broadcast_ps((const __m128*)&combMins[i * 4]);
+            __m256 mx = _mm256_broadcast_ps((const __m128*)&combMaxes[i * 4]);
+            __m256 out = _mm256_or_ps(_mm256_cmp_ps(v, mn, _CMP_LT_OQ), _mm256_cmp_ps(v, mx, _CMP_GT_OQ));
+            outside |= _mm256_movemask_ps(out);
+
+            // low 4 bits are point p, high 4 bits are point p + 1.
+            if ((outside & 0x0F) && (outside & 0xF0))
+                break;
+        }
+        if (!(outside & 0x0F))
+            return p;
+        if (!(outside & 0xF0))
+            return p + 1;
+    }
+    return anyPointInsideScalar(opp, numPoints, numChunks, p, end, combMins, combMaxes);
+}
+
+// AVX-512 version, same idea with 4 points per load. each nibble of the compare mask is one point.
+__attribute__((target("avx512f")))
+static int anyPointInsideAVX512(const float *opp, const int numPoints, const int numChunks, int start, const int end, const float *combMins, const float *combMaxes) {
+    int p = start;
+    for (; p + 4 <= end; p += 4) {
+        unsigned int outside = 0;
+        for (int i = 0; i < numChunks; i++) {
+            __m512 v = _mm512_loadu_ps(&opp[((size_t)i * numPoints + p) * 4]);
+            __m512 mn = _mm512_broadcast_f32x4(_mm_loadu_ps(&combMins[i * 4]));
+            __m512 mx = _mm512_broadcast_f32x4(_mm_loadu_ps(&combMaxes[i * 4]));
+            outside |= (unsigned int)(_mm512_cmp_ps_mask(v, mn, _CMP_LT_OQ) | _mm512_cmp_ps_mask(v, mx, _CMP_GT_OQ));
+
+            if ((outside & 0x000F) && (outside & 0x00F0) && (outside & 0x0F00) && (outside & 0xF000))
+                break;
+        }
+        for (int lane = 0; lane < 4; lane++) {
+            if (!((outside >> (lane * 4)) & 0xF))
+                return p + lane;
+        }
+    }
+    return anyPointInsideScalar(opp, numPoints, numChunks, p, end, combMins, combMaxes);
+}
+#endif
+
+// does the tile's bounding box overlap the combined block at all? if not, none of its points can be inside. same inclusive
+// edges as the point test, a point sitting right on the bound counts as inside.
+static inline bool tileTouchesBlock(const float *tileMin, const float *tileMax, const int numAttributes, const float *combMins, const float *combMaxes) {
+    for (int a = 0; a < numAttributes; a++) {
+        if (tileMax[a] < combMins[a] || tileMin[a] > combMaxes[a])
+            return false;
+    }
+    return true;
+}
+
+typedef int (*PointScanFn)(const float*, const int, const int, int, const int, const float*, const float*);
+
+// pick the widest scan this cpu can actually run. only done once.
+static PointScanFn pickPointScan(const char **levelName) {
+#ifdef HB_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        *levelName = "AVX-512";
+        return anyPointInsideAVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        *levelName = "AVX2";
+        return anyPointInsideAVX2;
+    }
+#endif
+    *levelName = "scalar";
+    return anyPointInsideScalar;
+}
+
+static const char *simdLevelName = "scalar";
+static const PointScanFn pointScan = pickPointScan(&simdLevelName);
+
+const char* cpuMergerSimdLevel() {
+    return simdLevelName;
+}
+
+// same thing as the kernel, but a whole wave of seeds at once. slot s is the seed at readSeedQueue[firstSeedIndex + s], and every other live block
+// tries to eat it. nothing gets written to the bounds here, we only fill in waveMergable[s * numBlocks + candidate], the caller commits.
+// a seed that nobody eats doesn't change anything (no bounds move, the queue stays the same), so the slots after it see exactly what they would have
+// one seed at a time. the first slot that does merge is still right, but everything after it was looking at stale bounds. so we quit on those slots
+// as soon as we know, and hand back the first merged slot (waveSize if none did).
+// the (slot, candidate) pairs are all independent, so they get split into a few tasks per thread. a candidate which doesn't need the dataset
+// scan is basically free, and one that does can take the whole dataset, so one chunk per thread would balance badly. tasks instead of a parallel
+// for so that when several classes are merging at once, they all feed the same pool of threads (outside of a parallel region it just runs on the calling thread).
+int mergerHyperBlocksWaveCPU(const int firstSeedIndex, const int waveSize, const int *readSeedQueue, const int numBlocks, const int numAttributes, const int numPoints, const float *opposingPoints, const float *tileMins, const float *tileMaxes, const float *hyperBlockMins, const float *hyperBlockMaxes, const int *deleteFlags, int *waveMergable, int *witnesses, int *witnessHeads) {
+
+    const int numAttributesAsFours = numAttributes / 4;
+    const int numTiles = (numPoints + OPPOSING_TILE_SIZE - 1) / OPPOSING_TILE_SIZE;
+
+    // which slot each block is the seed of. a seed from an earlier slot is already dead by the time the later slot runs, so it's not a candidate there.
+    vector<int> slotOfBlock(numBlocks, waveSize);
+    for (int s = 0; s < waveSize; s++) {
+        slotOfBlock[readSeedQueue[firstSeedIndex + s]] = s;
+    }
+
+    atomic<int> firstMergedSlot(waveSize);
+    const long long numPairs = (long long)waveSize * numBlocks;
+
+    // a handful of tasks per thread is plenty to balance it, more than that and making the tasks costs more than the skipped pairs do.
+    const long long numTasks = max(1LL, min(numPairs / 4, (long long)omp_get_num_threads() * 8));
+
+    #pragma omp taskloop num_tasks(numTasks) default(shared)
+    for (long long pair = 0; pair < numPairs; pair++) {
+        const int slot = (int)(pair / numBlocks);
+        const int candidate = (int)(pair % numBlocks);
+
+        // an earlier slot already merged, so this one is getting redone anyway.
+        if (slot > firstMergedSlot.load(memory_order_relaxed))
+            continue;
+        if (slotOfBlock[candidate] <= slot || deleteFlags[candidate] < 0)
+            continue;
+
+        // each thread gets its own combined bounds, this is the shared memory from the kernel.
+        static thread_local vector<float> combinedMins;
+        static thread_local vector<float> combinedMaxes;
+        combinedMins.resize(numAttributes);
+        combinedMaxes.resize(numAttributes);
+
+        const int seedBlock = readSeedQueue[firstSeedIndex + slot];
+        const float *seedMins = &hyperBlockMins[(size_t)seedBlock * numAttributes];
+        const float *seedMaxes = &hyperBlockMaxes[(size_t)seedBlock * numAttributes];
+        const float *candMins = &hyperBlockMins[(size_t)candidate * numAttributes];
+        const float *candMaxes = &hyperBlockMaxes[(size_t)candidate * numAttributes];
+
+        bool usedSeedBlock = false;
+        bool usedCandidateBlock = false;
+        for (int a = 0; a < numAttributes; a++) {
+            combinedMins[a] = min(seedMins[a], candMins[a]);
+            combinedMaxes[a] = max(seedMaxes[a], candMaxes[a]);
+
+            if (combinedMins[a] != seedMins[a] || combinedMaxes[a] != seedMaxes[a])
+                usedSeedBlock = true;
+            if (combinedMins[a] != candMins[a] || combinedMaxes[a] != candMaxes[a])
+                usedCandidateBlock = true;
+        }
+
+        // if the combined box is just one of the two blocks, we already know it's valid.
+        bool blockMergable = true;
+        if (usedSeedBlock && usedCandidateBlock) {
+            // the points which stopped this candidate before. bounds only grow, so they're usually still inside, and then we're done in a few compares.
+            int *ring = &witnesses[(size_t)candidate * WITNESS_RING_SIZE];
+            for (int w = 0; w < WITNESS_RING_SIZE && blockMergable; w++) {
+                int witness;
+                #pragma omp atomic read
+                witness = ring[w];
+                if (witness >= 0 && anyPointInsideScalar(opposingPoints, numPoints, numAttributesAsFours, witness, witness + 1, combinedMins.data(), combinedMaxes.data()) >= 0)
+                    blockMergable = false;
+            }
+
+            for (int t = 0; t < numTiles && blockMergable; t++) {
+                if (!tileTouchesBlock(&tileMins[(size_t)t * numAttributes], &tileMaxes[(size_t)t * numAttributes], numAttributes, combinedMins.data(), combinedMaxes.data()))
+                    continue;
+                const int start = t * OPPOSING_TILE_SIZE;
+                const int end = min(start + OPPOSING_TILE_SIZE, numPoints);
+                const int inside = pointScan(opposingPoints, numPoints, numAttributesAsFours, start, end, combinedMins.data(), combinedMaxes.data());
+                if (inside >= 0) {
+                    blockMergable = false;
+
+                    // remember who stopped us. other slots might be on this candidate at the same time, so the ring is atomics.
+                    int head;
+                    #pragma omp atomic capture
+                    head = witnessHeads[candidate]++;
+                    #pragma omp atomic write
+                    ring[head % WITNESS_RING_SIZE] = inside;
+                }
+            }
+        }
+
+        waveMergable[(size_t)slot * numBlocks + candidate] = blockMergable ? 1 : 0;
+
+        if (blockMergable) {
+            int current = firstMergedSlot.load(memory_order_relaxed);
+            while (slot < current && !firstMergedSlot.compare_exchange_weak(current, slot, memory_order_relaxed)) {}
+        }
+    }
+
+    return firstMergedSlot.load();
+}
+
+// the slots up to lastSlot are the ones we keep. their seeds are dead now (-9), if lastSlot merged its seed is -1 instead,
+// and every candidate which ate it takes the combined bounds. same writes the kernel did at the end of each seed.
+void commitMergeWaveCPU(const int firstSeedIndex, const int lastSlot, const bool lastSlotMerged, const int *readSeedQueue, const int numBlocks, const int numAttributes, float *hyperBlockMins, float *hyperBlockMaxes, int *deleteFlags, const int *slotMergable) {
+    for (int s = 0; s <= lastSlot; s++) {
+        deleteFlags[readSeedQueue[firstSeedIndex + s]] = min(deleteFlags[readSeedQueue[firstSeedIndex + s]], -9);
+    }
+    if (!lastSlotMerged)
+        return;
+
+    const int seedBlock = readSeedQueue[firstSeedIndex + lastSlot];
+    deleteFlags[seedBlock] = max(deleteFlags[seedBlock], -1);
+
+    const float *seedMins = &hyperBlockMins[(size_t)seedBlock * numAttributes];
+    const float *seedMaxes = &hyperBlockMaxes[(size_t)seedBlock * numAttributes];
+
+    // the commit only touches candidates that live after the seed in the queue, so those are the ones that have a flag for this slot.
+    #pragma omp taskloop grainsize(256) default(shared)
+    for (int q = firstSeedIndex + lastSlot + 1; q < numBlocks; q++) {
+        const int candidate = readSeedQueue[q];
+        if (slotMergable[candidate] != 1)
+            continue;
+        float *candMins = &hyperBlockMins[(size_t)candidate * numAttributes];
+        float *candMaxes = &hyperBlockMaxes[(size_t)candidate * numAttributes];
+        for (int a = 0; a < numAttributes; a++) {
+            candMins[a] = min(seedMins[a], candMins[a]);
+            candMaxes[a] = max(seedMaxes[a], candMaxes[a]);
+        }
+    }
+}
+
+// the kernel version computes each new position by counting, since every thread does one slot. here we just walk it once.
+void rearrangeSeedQueueCPU(const int deadSeedNum, const int *readSeedQueue, int *writeSeedQueue, const int *mergable, const int numBlocks) {
+    for (int i = 0; i <= deadSeedNum && i < numBlocks; i++) {
+        writeSeedQueue[i] = readSeedQueue[i];
+    }
+
+    int front = deadSeedNum + 1;
+    int back = numBlocks - 1;
+    for (int i = deadSeedNum + 1; i < numBlocks; i++) {
+        const int seed = readSeedQueue[i];
+        if (mergable[seed] == 0)
+            writeSeedQueue[front++] = seed;
+        else
+            writeSeedQueue[back--] = seed;
+    }
+}
+
+// checks if a point is inside one block in the flattenMinsMaxesForRUB encoding. [blockStart, blockEnd) is the block's slice of mins/maxes.
+// for disjunctions, being inside any one of the intervals of an attribute is good enough.
+static bool insideEncodedBlock(const float *point, const float *blockMins, const float *blockMaxes, const float *endOfBlock) {
+    int particularAttribute = 0;
+    while (blockMins < endOfBlock) {
+        int countOfThisAttribute = (int)*blockMins;
+        blockMins++;
+        blockMaxes++;
+
+        bool inBounds = false;
+        for (int i = 0; i < countOfThisAttribute; i++) {
+            const float pointValue = point[particularAttribute];
+            if (pointValue >= blockMins[i] && pointValue <= blockMaxes[i]) {
+                inBounds = true;
+                break;
+            }
+        }
+        if (!inBounds)
+            return false;
+
+        blockMins += countOfThisAttribute;
+        blockMaxes += countOfThisAttribute;
+        particularAttribute++;
+    }
+    return true;
+}
+
+// lowest set bit at or after bit from, -1 if there isn't one.
+static inline int nextSetBit(const uint64_t *bits, int numWords, int from) {
+    int w = from >> 6;
+    if (w >= numWords)
+        return -1;
+    uint64_t word = bits[w] & (~0ULL << (from & 63));
+    while (!word) {
+        if (++w >= numWords)
+            return -1;
+        word = bits[w];
+    }
+    return (w << 6) + __builtin_ctzll(word);
+}
+
+void BlockStabbingIndex::build(const float *dataPointsArray, const int numAttributes, const int numPoints, const float *blockMins, const float *blockMaxes, const int *blockEdges, const int numBlocks) {
+    numWords = (numBlocks + 63) / 64;
+    numBuckets = max(1, min(STABBING_BUCKETS, numPoints));
+    this->numPoints = numPoints;
+    attributes.clear();
+
+    // with a handful of blocks walking all of them is cheaper than sorting the points, candidates() just hands back every block then.
+    // no points means no buckets to cut them into either.
+    if (numBlocks < STABBING_MIN_BLOCKS || numPoints == 0)
+        return;
+
+    // where every attribute's intervals start in each block, same walk as insideEncodedBlock.
+    vector<int> attrStarts((size_t)numBlocks * numAttributes);
+    vector<double> widths(numAttributes, 0.0);
+    for (int b = 0; b < numBlocks; b++) {
+        int offset = blockEdges[b];
+        for (int a = 0; a < numAttributes; a++) {
+            attrStarts[(size_t)b * numAttributes + a] = offset;
+            const int count = (int)blockMins[offset];
+            for (int i = 1; i <= count; i++)
+                widths[a] += blockMaxes[offset + i] - blockMins[offset + i];
+            offset += count + 1;
+        }
+    }
+
+    // the narrowest attributes (summed over all the blocks) throw out the most blocks per point. the data is normalized, so widths are comparable,
+    // and removed attributes are [0, 1] everywhere so they never get picked.
+    vector<int> byWidth(numAttributes);
+    iota(byWidth.begin(), byWidth.end(), 0);
+    stable_sort(byWidth.begin(), byWidth.end(), [&](int x, int y) { return widths[x] < widths[y]; });
+    attributes.assign(byWidth.begin(), byWidth.begin() + min(STABBING_ATTRIBUTES, numAttributes));
+    const int numIndexed = attributes.size();
+
+    bucketOfPoint.assign((size_t)numIndexed * numPoints, 0);
+    bits.assign((size_t)numIndexed * numBuckets * numWords, 0);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < numIndexed; k++) {
+        const int a = attributes[k];
+
+        // cut the points into equal buckets along this attribute. a bucket covers [low, high] of its points' values, in order.
+        vector<int> order(numPoints);
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](int x, int y) { return dataPointsArray[(size_t)x * numAttributes + a] < dataPointsArray[(size_t)y * numAttributes + a]; });
+
+        vector<float> lows(numBuckets);
+        vector<float> highs(numBuckets);
+        for (int bucket = 0; bucket < numBuckets; bucket++) {
+            const int first = (int)((long long)numPoints * bucket / numBuckets);
+            const int last = (int)((long long)numPoints * (bucket + 1) / numBuckets) - 1;
+            lows[bucket] = dataPointsArray[(size_t)order[first] * numAttributes + a];
+            highs[bucket] = dataPointsArray[(size_t)order[last] * numAttributes + a];
+            for (int r = first; r <= last; r++)
+                bucketOfPoint[(size_t)k * numPoints + order[r]] = bucket;
+        }
+
+        // every block goes into the buckets any of its intervals reach into.
+        uint64_t *attrBits = &bits[(size_t)k * numBuckets * numWords];
+        for (int b = 0; b < numBlocks; b++) {
+            const int offset = attrStarts[(size_t)b * numAttributes + a];
+            const int count = (int)blockMins[offset];
+            for (int i = 1; i <= count; i++) {
+                const int firstBucket = lower_bound(highs.begin(), highs.end(), blockMins[offset + i]) - highs.begin();
+                const int lastBucket = (int)(upper_bound(lows.begin(), lows.end(), blockMaxes[offset + i]) - lows.begin()) - 1;
+                for (int bucket = firstBucket; bucket <= lastBucket; bucket++)
+                    attrBits[(size_t)bucket * numWords + (b >> 6)] |= 1ULL << (b & 63);
+            }
+        }
+    }
+}
+
+void BlockStabbingIndex::candidates(const int p, uint64_t *out) const {
+    if (attributes.empty()) {
+        for (int w = 0; w < numWords; w++)
+            out[w] = ~0ULL;
+        return;
+    }
+    const uint64_t *first = &bits[(size_t)bucketOfPoint[p] * numWords];
+    copy(first, first + numWords, out);
+    for (int k = 1; k < (int)attributes.size(); k++) {
+        const uint64_t *more = &bits[((size_t)k * numBuckets + bucketOfPoint[(size_t)k * numPoints + p]) * numWords];
+        for (int w = 0; w < numWords; w++)
+            out[w] &= more[w];
+    }
+}
+
+// each point goes into the first block it fits in, -1 if none. only the blocks the index says could hold it get checked.
+void assignPointsToBlocksCPU(const float *dataPointsArray, const int numAttributes, const int numPoints, const float *blockMins, const float *blockMaxes, const int *blockEdges, const int numBlocks, const BlockStabbingIndex &index, int *dataPointBlocks) {
+    #pragma omp parallel
+    {
+        vector<uint64_t> candidates(index.words());
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int p = 0; p < numPoints; p++) {
+            const float *point = &dataPointsArray[(size_t)p * numAttributes];
+            index.candidates(p, candidates.data());
+            dataPointBlocks[p] = -1;
+            for (int b = nextSetBit(candidates.data(), index.words(), 0); b != -1 && b < numBlocks; b = nextSetBit(candidates.data(), index.words(), b + 1)) {
+                if (insideEncodedBlock(point, &blockMins[blockEdges[b]], &blockMaxes[blockEdges[b]], &blockMins[blockEdges[b + 1]])) {
+                    dataPointBlocks[p] = b;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void sumPointsPerBlockCPU(const int *dataPointBlocks, const int numPoints, int *numPointsInBlocks) {
+    for (int p = 0; p < numPoints; p++) {
+        if (dataPointBlocks[p] >= 0)
+            numPointsInBlocks[dataPointBlocks[p]]++;
+    }
+}
+
+// starting from the block we picked, move the point to any later block it fits in which has strictly more points than where it is now.
+void findBetterBlocksCPU(const float *dataPointsArray, const int numAttributes, const int numPoints, const float *blockMins, const float *blockMaxes, const int *blockEdges, const int numBlocks, const BlockStabbingIndex &index, int *dataPointBlocks, const int *numPointsInBlocks) {
+    #pragma omp parallel
+    {
+        vector<uint64_t> candidates(index.words());
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int p = 0; p < numPoints; p++) {
+            int currentBlock = dataPointBlocks[p];
+
+            // coverage issue, nothing to improve.
+            if (currentBlock == -1)
+                continue;
+
+            const float *point = &dataPointsArray[(size_t)p * numAttributes];
+            int largestBlockSize = numPointsInBlocks[currentBlock];
+            index.candidates(p, candidates.data());
+
+            for (int b = nextSetBit(candidates.data(), index.words(), currentBlock + 1); b != -1 && b < numBlocks; b = nextSetBit(candidates.data(), index.words(), b + 1)) {
+                // cheap count check first, then the actual bounds.
+                if (numPointsInBlocks[b] <= largestBlockSize)
+                    continue;
+                if (insideEncodedBlock(point, &blockMins[blockEdges[b]], &blockMaxes[blockEdges[b]], &blockMins[blockEdges[b + 1]])) {
+                    dataPointBlocks[p] = b;
+                    largestBlockSize = numPointsInBlocks[b];
+                }
+            }
+        }
+    }
+}
+
+// how many points go into one piece of the containment listing.
+#define COVERAGE_CHUNK 1024
+
+void BlockCoverage::build(const float *dataPointsArray, const int numAttributes, const int numPoints, const float *blockMins, const float *blockMaxes, const int *blockEdges, const int numBlocks) {
+    BlockStabbingIndex index;
+    index.build(dataPointsArray, numAttributes, numPoints, blockMins, blockMaxes, blockEdges, numBlocks);
+
+    // every block each point is inside of. chunks of points get listed in parallel, then stuck together in order.
+    const int numChunks = (numPoints + COVERAGE_CHUNK - 1) / COVERAGE_CHUNK;
+    vector<vector<int>> chunkBlocks(numChunks);
+    pointStart.assign(numPoints + 1, 0);
+
+    #pragma omp parallel
+    {
+        vector<uint64_t> candidates(index.words());
+
+        #pragma omp for schedule(dynamic)
+        for (int chunk = 0; chunk < numChunks; chunk++) {
+            const int end = min(numPoints, (chunk + 1) * COVERAGE_CHUNK);
+            for (int p = chunk * COVERAGE_CHUNK; p < end; p++) {
+                const float *point = &dataPointsArray[(size_t)p * numAttributes];
+                index.candidates(p, candidates.data());
+                for (int b = nextSetBit(candidates.data(), index.words(), 0); b != -1 && b < numBlocks; b = nextSetBit(candidates.data(), index.words(), b + 1)) {
+                    if (insideEncodedBlock(point, &blockMins[blockEdges[b]], &blockMaxes[blockEdges[b]], &blockMins[blockEdges[b + 1]])) {
+                        chunkBlocks[chunk].push_back(b);
+                        pointStart[p + 1]++;
+                    }
+                }
+            }
+        }
+    }
+
+    for (int p = 0; p < numPoints; p++)
+        pointStart[p + 1] += pointStart[p];
+    pointBlocks.clear();
+    pointBlocks.reserve(pointStart[numPoints]);
+    for (auto &blocks : chunkBlocks)
+        pointBlocks.insert(pointBlocks.end(), blocks.begin(), blocks.end());
+
+    // and flipped around, the points inside each block. walking the points in order keeps every block's list ascending.
+    blockStart.assign(numBlocks + 1, 0);
+    for (int b : pointBlocks)
+        blockStart[b + 1]++;
+    for (int b = 0; b < numBlocks; b++)
+        blockStart[b + 1] += blockStart[b];
+    blockPoints.resize(pointBlocks.size());
+    vector<int> fillAt(blockStart.begin(), blockStart.end() - 1);
+    for (int p = 0; p < numPoints; p++)
+        for (int i = pointStart[p]; i < pointStart[p + 1]; i++)
+            blockPoints[fillAt[pointBlocks[i]]++] = p;
+
+    alive.resize(numBlocks);
+    iota(alive.begin(), alive.end(), 0);
+    removed.assign(numBlocks, 0);
+
+    // ASSIGN -> SUM -> FIND BETTER -> SUM, off the lists.
+    firstChoice.resize(numPoints);
+    finalChoice.resize(numPoints);
+    firstCounts.assign(numBlocks, 0);
+    finalCounts.assign(numBlocks, 0);
+
+    #pragma omp parallel for
+    for (int p = 0; p < numPoints; p++)
+        firstChoice[p] = firstBlock(p);
+    for (int p = 0; p < numPoints; p++)
+        if (firstChoice[p] >= 0)
+            firstCounts[firstChoice[p]]++;
+
+    #pragma omp parallel for
+    for (int p = 0; p < numPoints; p++)
+        finalChoice[p] = betterBlock(p);
+    for (int p = 0; p < numPoints; p++)
+        if (finalChoice[p] >= 0)
+            finalCounts[finalChoice[p]]++;
+}
+
+int BlockCoverage::firstBlock(const int p) const {
+    for (int i = pointStart[p]; i < pointStart[p + 1]; i++)
+        if (!removed[pointBlocks[i]])
+            return pointBlocks[i];
+    return -1;
+}
+
+int BlockCoverage::betterBlock(const int p) const {
+    const int first = firstChoice[p];
+    if (first == -1)
+        return -1;
+
+    int best = first;
+    int largestBlockSize = firstCounts[first];
+    for (int i = pointStart[p]; i < pointStart[p + 1]; i++) {
+        const int b = pointBlocks[i];
+        if (b > first && !removed[b] && firstCounts[b] > largestBlockSize) {
+            best = b;
+            largestBlockSize = firstCounts[b];
+        }
+    }
+    return best;
+}
+
+void BlockCoverage::removeBlocks(const vector<int> &positions) {
+    if (positions.empty())
+        return;
+
+    const int numPoints = firstChoice.size();
+    vector<char> touched(numPoints, 0);
+    vector<int> touchedPoints;
+    vector<int> removedBlocks;
+
+    for (int position : positions) {
+        removed[alive[position]] = 1;
+        removedBlocks.push_back(alive[position]);
+    }
+    alive.erase(remove_if(alive.begin(), alive.end(), [&](int b) { return removed[b]; }), alive.end());
+
+    // the points that had a deleted block as their first choice move to the next one they're inside of. that changes its first pass count too.
+    vector<int> changedBlocks(removedBlocks);
+    for (int b : removedBlocks) {
+        for (int j = blockStart[b]; j < blockStart[b + 1]; j++) {
+            const int p = blockPoints[j];
+            if (firstChoice[p] != b)
+                continue;
+            firstCounts[b]--;
+            firstChoice[p] = firstBlock(p);
+            if (firstChoice[p] >= 0) {
+                firstCounts[firstChoice[p]]++;
+                changedBlocks.push_back(firstChoice[p]);
+            }
+        }
+    }
+
+    // any point inside of a block which is gone, or whose count moved, might choose differently in FIND BETTER. nobody else can.
+    sort(changedBlocks.begin(), changedBlocks.end());
+    changedBlocks.erase(unique(changedBlocks.begin(), changedBlocks.end()), changedBlocks.end());
+    for (int b : changedBlocks) {
+        for (int j = blockStart[b]; j < blockStart[b + 1]; j++) {
+            const int p = blockPoints[j];
+            if (!touched[p]) {
+                touched[p] = 1;
+                touchedPoints.push_back(p);
+            }
+        }
+    }
+
+    vector<int> newChoice(touchedPoints.size());
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < (int)touchedPoints.size(); i++)
+        newChoice[i] = betterBlock(touchedPoints[i]);
+
+    for (int i = 0; i < (int)touchedPoints.size(); i++) {
+        const int p = touchedPoints[i];
+        if (finalChoice[p] >= 0)
+            finalCounts[finalChoice[p]]--;
+        finalChoice[p] = newChoice[i];
+        if (finalChoice[p] >= 0)
+            finalCounts[finalChoice[p]]++;
+    }
+}
+
+// ------------------------ removing useless attributes, with the sorted columns -------------------------
+// the kernels test every wrong class point against every attribute, again for every attribute they try to take out. on the CPU we sort the
+// columns once (separateByAttribute), and each interval of a block becomes a window [first, last] of ranks in its column, like topBottomPairs.
+// the wrong class points inside a block minus one attribute are then the intersection of the other attributes' windows, which we do as sets
+// of global point ids (row p of the dataset is id p): start from the narrowest window, and knock survivors out one attribute at a time.
+
+// one block's windows. attribute a's intervals are slots [slotStart[a], slotStart[a + 1]), their bounds at offsets[a] + i in the block's mins / maxes.
+struct BlockWindows {
+    vector<int> slotStart;
+    vector<int> first;
+    vector<int> last;
+    vector<int> sizes; // points in all of an attribute's windows
+    vector<int> order; // attributes, smallest windows first
+};
+
+static void findWindows(const vector<DataATTR> &column, float low, float high, int &first, int &last) {
+    first = lower_bound(column.begin(), column.end(), low, [](const DataATTR &d, float v) { return d.value < v; }) - column.begin();
+    last = (int)(upper_bound(column.begin(), column.end(), high, [](float v, const DataATTR &d) { return v < d.value; }) - column.begin()) - 1;
+}
+
+static void windowsOfAttribute(const AttributeColumns &columns, const float *blockMins, const float *blockMaxes, const int *offsets, const int *intervalCounts, int a, BlockWindows &w) {
+    w.sizes[a] = 0;
+    for (int i = 0; i < intervalCounts[a]; i++) {
+        const int slot = w.slotStart[a] + i;
+        findWindows(columns[a], blockMins[offsets[a] + i], blockMaxes[offsets[a] + i], w.first[slot], w.last[slot]);
+        w.sizes[a] += max(0, w.last[slot] - w.first[slot] + 1);
+    }
+}
+
+static void buildBlockWindows(const AttributeColumns &columns, const float *blockMins, const float *blockMaxes, const int *offsets, const int *intervalCounts, int fieldLen, BlockWindows &w) {
+    w.slotStart.resize(fieldLen + 1);
+    w.slotStart[0] = 0;
+    for (int a = 0; a < fieldLen; a++)
+        w.slotStart[a + 1] = w.slotStart[a] + intervalCounts[a];
+    w.first.resize(w.slotStart[fieldLen]);
+    w.last.resize(w.slotStart[fieldLen]);
+    w.sizes.resize(fieldLen);
+    w.order.resize(fieldLen);
+    for (int a = 0; a < fieldLen; a++) {
+        windowsOfAttribute(columns, blockMins, blockMaxes, offsets, intervalCounts, a, w);
+        w.order[a] = a;
+    }
+    stable_sort(w.order.begin(), w.order.end(), [&](int x, int y) { return w.sizes[x] < w.sizes[y]; });
+}
+
+// is there a wrong class point inside the block on every attribute except skip? survivors and bits are scratch, bits has to come in (and goes out) zeroed.
+// a window smaller than the survivor list gets ORed into the bitmap and ANDed against it, otherwise it's cheaper to check the survivors' values directly.
+static bool wrongClassInsideWithout(const AttributeColumns &columns, const float *dataset, const int fieldLen, const float *blockMins, const float *blockMaxes, const int *offsets, const int *intervalCounts, const BlockWindows &w, const int skip, const int classStart, const int classEnd, vector<int> &survivors, vector<uint64_t> &bits) {
+    int k = 0;
+    while (k < fieldLen && w.order[k] == skip)
+        k++;
+
+    // no attributes left to hold anyone out, so every wrong class point is inside.
+    if (k == fieldLen)
+        return classEnd - classStart < columns.numPoints();
+
+    const int seed = w.order[k];
+    survivors.clear();
+    for (int slot = w.slotStart[seed]; slot < w.slotStart[seed + 1]; slot++) {
+        for (int r = w.first[slot]; r <= w.last[slot]; r++) {
+            const int id = columns[seed][r].id;
+            if (id < classStart || id >= classEnd)
+                survivors.push_back(id);
+        }
+    }
+
+    for (k++; k < fieldLen && !survivors.empty(); k++) {
+        const int a = w.order[k];
+        if (a == skip)
+            continue;
+
+        if (w.sizes[a] < (int)survivors.size()) {
+            for (int slot = w.slotStart[a]; slot < w.slotStart[a + 1]; slot++)
+                for (int r = w.first[slot]; r <= w.last[slot]; r++)
+                    bits[columns[a][r].id >> 6] |= 1ULL << (columns[a][r].id & 63);
+
+            survivors.erase(remove_if(survivors.begin(), survivors.end(), [&](int id) { return !((bits[id >> 6] >> (id & 63)) & 1ULL); }), survivors.end());
+
+            for (int slot = w.slotStart[a]; slot < w.slotStart[a + 1]; slot++)
+                for (int r = w.first[slot]; r <= w.last[slot]; r++)
+                    bits[columns[a][r].id >> 6] = 0;
+        }
+        else {
+            survivors.erase(remove_if(survivors.begin(), survivors.end(), [&](int id) {
+                const float v = dataset[(size_t)id * fieldLen + a];
+                for (int i = 0; i < intervalCounts[a]; i++) {
+                    if (v <= blockMaxes[offsets[a] + i] && v >= blockMins[offsets[a] + i])
+                        return false;
+                }
+                return true;
+            }), survivors.end());
+        }
+    }
+    return !survivors.empty();
+}
+
+// disjunction friendly one, same results as the kernel. no checkOrder, that's for the kernel's point loop, here the window sizes pick the order.
+void removeUselessAttributesCPU(float* mins, float* maxes, const int* intervalCounts, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder) {
+
+    const AttributeColumns columns = IntervalHyperBlock::separateByAttribute(dataset, numPoints, classBorder, numClasses, fieldLen);
+
+    #pragma omp parallel
+    {
+        BlockWindows w;
+        vector<int> survivors;
+        vector<uint64_t> bits((numPoints + 63) / 64, 0);
+        vector<int> attrOffsets(fieldLen);
+
+        #pragma omp for schedule(dynamic)
+        for (int b = 0; b < numBlocks; b++) {
+            float* blockMins = &mins[blockEdges[b]];
+            float* blockMaxes = &maxes[blockEdges[b]];
+            const int* blockIntervalCounts = &intervalCounts[b * fieldLen];
+            const int classNum = blockClasses[b];
+
+            // where each attribute's intervals start. every attribute has its interval count in front of it, so skip over that too.
+            int runningOffset = 0;
+            for (int a = 0; a < fieldLen; a++) {
+                attrOffsets[a] = runningOffset + 1;
+                runningOffset += blockIntervalCounts[a] + 1;
+            }
+            buildBlockWindows(columns, blockMins, blockMaxes, attrOffsets.data(), blockIntervalCounts, fieldLen, w);
+
+            for (int removedIndex = 0; removedIndex < fieldLen; removedIndex++) {
+                const int removed = attributeOrder[fieldLen * classNum + removedIndex];
+                const int checkOffset = attrOffsets[removed];
+
+                // already removed.
+                if (blockMins[checkOffset] == 0.0f && blockMaxes[checkOffset] == 1.0f)
+                    continue;
+
+                if (wrongClassInsideWithout(columns, dataset, fieldLen, blockMins, blockMaxes, attrOffsets.data(), blockIntervalCounts, w, removed, classBorder[classNum], classBorder[classNum + 1], survivors, bits))
+                    continue;
+
+                for (int i = 0; i < blockIntervalCounts[removed]; i++) {
+                    blockMins[checkOffset + i] = 0.0f;
+                    blockMaxes[checkOffset + i] = 1.0f;
+                }
+                attrRemoveFlags[fieldLen * b + removed] = 1;
+
+                // the attribute is [0, 1] now, so its windows grow.
+                windowsOfAttribute(columns, blockMins, blockMaxes, attrOffsets.data(), blockIntervalCounts, removed, w);
+                stable_sort(w.order.begin(), w.order.end(), [&](int x, int y) { return w.sizes[x] < w.sizes[y]; });
+            }
+        }
+    }
+}
+
+// ------------------------ searching for a better attribute removal order -------------------------
+// point p "escapes" attribute a when its value is outside all of the block's intervals on a. taking attributes out of the block is fine as long as every
+// wrong class point still escapes one of the attributes we kept. so a block only needs the escape sets of its wrong class points as bitmasks over the
+// attributes, and only the minimal ones (anything escaping a superset of another point's set is kept out whenever that point is).
+// an order then just walks its attributes keeping a count of kept escapes per mask: a can go if no mask with a in it is down to its last one.
+
+struct EscapeMasks {
+    int words = 0;
+    vector<uint64_t> masks;     // masks[m * words + w]
+    vector<int> attrStart;      // masks escaping attribute a are attrMasks[attrStart[a] .. attrStart[a + 1])
+    vector<int> attrMasks;
+    vector<int> live;           // attributes not already [0, 1]
+    bool wrongPointInside = false;
+
+    int size() const { return words == 0 ? 0 : masks.size() / words; }
+};
+
+// the escape sets come off the sorted columns too. every wrong class point starts out escaping all the live attributes, and walking attribute a's
+// windows clears bit a for the wrong class points in them. so the work is the size of the windows, not numPoints times the attributes.
+// pointMasks (numPoints * words) and touched (numPoints) are scratch, touched has to come in zeroed and goes out zeroed.
+static void buildEscapeMasks(const AttributeColumns &columns, const int fieldLen, const float *blockMins, const float *blockMaxes, const int *offsets, const int *intervalCounts, const int classStart, const int classEnd, BlockWindows &w, vector<uint64_t> &pointMasks, vector<char> &touched, vector<int> &touchedIds, EscapeMasks &e) {
+    const int words = (fieldLen + 63) / 64;
+    e.words = words;
+    e.wrongPointInside = false;
+    e.live.clear();
+    vector<uint64_t> liveMask(words, 0);
+    for (int a = 0; a < fieldLen; a++) {
+        if (!(blockMins[offsets[a]] == 0.0f && blockMaxes[offsets[a]] == 1.0f)) {
+            e.live.push_back(a);
+            liveMask[a >> 6] |= 1ULL << (a & 63);
+        }
+    }
+
+    buildBlockWindows(columns, blockMins, blockMaxes, offsets, intervalCounts, fieldLen, w);
+
+    // the wrong class points in a's windows don't escape a.
+    touchedIds.clear();
+    for (int a : e.live) {
+        for (int slot = w.slotStart[a]; slot < w.slotStart[a + 1]; slot++) {
+            for (int r = w.first[slot]; r <= w.last[slot]; r++) {
+                const int id = columns[a][r].id;
+                if (id >= classStart && id < classEnd)
+                    continue;
+                uint64_t *mask = &pointMasks[(size_t)id * words];
+                if (!touched[id]) {
+                    touched[id] = 1;
+                    touchedIds.push_back(id);
+                    copy(liveMask.begin(), liveMask.end(), mask);
+                }
+                mask[a >> 6] &= ~(1ULL << (a & 63));
+            }
+        }
+    }
+
+    // every wrong class point's escape set. the ones in none of the windows escape everything live.
+    vector<uint64_t> all;
+    const int numWrong = columns.numPoints() - (classEnd - classStart);
+    if ((int)touchedIds.size() < numWrong)
+        all.insert(all.end(), liveMask.begin(), liveMask.end());
+    for (int id : touchedIds) {
+        const uint64_t *mask = &pointMasks[(size_t)id * words];
+        all.insert(all.end(), mask, mask + words);
+        touched[id] = 0;
+    }
+
+    // inside on every attribute already, nothing can come out.
+    const int numMasks = all.size() / words;
+    for (int m = 0; m < numMasks; m++) {
+        if (all_of(&all[(size_t)m * words], &all[(size_t)m * words + words], [](uint64_t x) { return x == 0; })) {
+            e.wrongPointInside = true;
+            e.masks.clear();
+            return;
+        }
+    }
+
+    // throw out repeats and anything that's a superset of a smaller mask. smallest masks first, so a mask only gets compared to ones that could be inside it.
+    vector<int> order(numMasks);
+    vector<int> bitCount(numMasks, 0);
+    for (int m = 0; m < numMasks; m++) {
+        order[m] = m;
+        for (int w = 0; w < words; w++)
+            bitCount[m] += __builtin_popcountll(all[(size_t)m * words + w]);
+    }
+    sort(order.begin(), order.end(), [&](int x, int y) {
+        if (bitCount[x] != bitCount[y])
+            return bitCount[x] < bitCount[y];
+        return lexicographical_compare(&all[(size_t)x * words], &all[(size_t)x * words + words], &all[(size_t)y * words], &all[(size_t)y * words + words]);
+    });
+
+    e.masks.clear();
+    const uint64_t *previous = nullptr;
+    for (int m : order) {
+        const uint64_t *candidate = &all[(size_t)m * words];
+        if (previous && equal(candidate, candidate + words, previous))
+            continue;
+        previous = candidate;
+
+        bool covered = false;
+        for (int k = 0; k < e.size() && !covered; k++) {
+            const uint64_t *kept = &e.masks[(size_t)k * words];
+            covered = true;
+            for (int w = 0; w < words && covered; w++)
+                covered = (kept[w] & ~candidate[w]) == 0;
+        }
+        if (!covered)
+            e.masks.insert(e.masks.end(), candidate, candidate + words);
+    }
+
+    // and which masks each attribute shows up in.
+    e.attrStart.assign(fieldLen + 1, 0);
+    for (int k = 0; k < e.size(); k++)
+        for (int a = 0; a < fieldLen; a++)
+            if ((e.masks[(size_t)k * words + (a >> 6)] >> (a & 63)) & 1ULL)
+                e.attrStart[a + 1]++;
+    for (int a = 0; a < fieldLen; a++)
+        e.attrStart[a + 1] += e.attrStart[a];
+    e.attrMasks.resize(e.attrStart[fieldLen]);
+    vector<int> fillAt(e.attrStart.begin(), e.attrStart.end() - 1);
+    for (int k = 0; k < e.size(); k++)
+        for (int a = 0; a < fieldLen; a++)
+            if ((e.masks[(size_t)k * words + (a >> 6)] >> (a & 63)) & 1ULL)
+                e.attrMasks[fillAt[a]++] = k;
+}
+
+// starting count of kept escapes for every mask, everything live is kept.
+static void resetKept(const EscapeMasks &e, vector<int> &kept) {
+    kept.resize(e.size());
+    for (int k = 0; k < e.size(); k++) {
+        kept[k] = 0;
+        for (int w = 0; w < e.words; w++)
+            kept[k] += __builtin_popcountll(e.masks[(size_t)k * e.words + w]);
+    }
+}
+
+static bool canRemove(const EscapeMasks &e, const vector<int> &kept, int a) {
+    for (int i = e.attrStart[a]; i < e.attrStart[a + 1]; i++)
+        if (kept[e.attrMasks[i]] == 1)
+            return false;
+    return true;
+}
+
+static void removeAttribute(const EscapeMasks &e, vector<int> &kept, int a) {
+    for (int i = e.attrStart[a]; i < e.attrStart[a + 1]; i++)
+        kept[e.attrMasks[i]]--;
+}
+
+// take attributes out in this order wherever we can, like the kernel does. returns how many clauses came out.
+static int tryOrder(const EscapeMasks &e, const int *order, const int fieldLen, const int *intervalCounts, const vector<char> &isLive, vector<int> &kept, vector<char> &removed) {
+    resetKept(e, kept);
+    fill(removed.begin(), removed.end(), 0);
+    int clauses = 0;
+    for (int i = 0; i < fieldLen; i++) {
+        const int a = order[i];
+        if (!isLive[a] || !canRemove(e, kept, a))
+            continue;
+        removeAttribute(e, kept, a);
+        removed[a] = 1;
+        clauses += intervalCounts[a];
+    }
+    return clauses;
+}
+
+// keep taking out whichever attribute has the most clauses, and out of those the one that leaves the fewest masks down to their last escape.
+static int greedyOrder(const EscapeMasks &e, const int *order, const int fieldLen, const int *intervalCounts, const vector<char> &isLive, vector<int> &kept, vector<char> &removed) {
+    resetKept(e, kept);
+    fill(removed.begin(), removed.end(), 0);
+    int clauses = 0;
+    while (true) {
+        int best = -1;
+        int bestCritical = 0;
+        for (int i = 0; i < fieldLen; i++) {
+            const int a = order[i];
+            if (!isLive[a] || removed[a] || !canRemove(e, kept, a))
+                continue;
+            int critical = 0;
+            for (int j = e.attrStart[a]; j < e.attrStart[a + 1]; j++)
+                critical += kept[e.attrMasks[j]] == 2;
+            if (best == -1 || intervalCounts[a] > intervalCounts[best] || (intervalCounts[a] == intervalCounts[best] && critical < bestCritical)) {
+                best = a;
+                bestCritical = critical;
+            }
+        }
+        if (best == -1)
+            return clauses;
+        removeAttribute(e, kept, best);
+        removed[best] = 1;
+        clauses += intervalCounts[best];
+    }
+}
+
+void searchRemovalOrderingsCPU(float* mins, float* maxes, const int* intervalCounts, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder) {
+
+    const AttributeColumns columns = IntervalHyperBlock::separateByAttribute(dataset, numPoints, classBorder, numClasses, fieldLen);
+
+    #pragma omp parallel
+    {
+        EscapeMasks e;
+        BlockWindows w;
+        vector<uint64_t> pointMasks((size_t)numPoints * ((fieldLen + 63) / 64));
+        vector<char> touched(numPoints, 0);
+        vector<int> touchedIds;
+        vector<int> attrOffsets(fieldLen);
+        vector<int> kept;
+        vector<char> isLive(fieldLen);
+        vector<char> removed(fieldLen);
+        vector<char> bestRemoved(fieldLen);
+        vector<int> order(fieldLen);
+
+        #pragma omp for schedule(dynamic)
+        for (int b = 0; b < numBlocks; b++) {
+            float* blockMins = &mins[blockEdges[b]];
+            float* blockMaxes = &maxes[blockEdges[b]];
+            const int* blockIntervalCounts = &intervalCounts[b * fieldLen];
+            const int classNum = blockClasses[b];
+            const int *givenOrder = &attributeOrder[fieldLen * classNum];
+
+            int runningOffset = 0;
+            for (int a = 0; a < fieldLen; a++) {
+                attrOffsets[a] = runningOffset + 1;
+                runningOffset += blockIntervalCounts[a] + 1;
+            }
+
+            buildEscapeMasks(columns, fieldLen, blockMins, blockMaxes, attrOffsets.data(), blockIntervalCounts, classBorder[classNum], classBorder[classNum + 1], w, pointMasks, touched, touchedIds, e);
+            if (e.wrongPointInside)
+                continue;
+
+            fill(isLive.begin(), isLive.end(), 0);
+            for (int a : e.live)
+                isLive[a] = 1;
+
+            // the given order first, so it wins every tie.
+            int bestClauses = tryOrder(e, givenOrder, fieldLen, blockIntervalCounts, isLive, kept, bestRemoved);
+            auto consider = [&](int clauses) {
+                if (clauses > bestClauses) {
+                    bestClauses = clauses;
+                    bestRemoved = removed;
+                }
+            };
+
+            reverse_copy(givenOrder, givenOrder + fieldLen, order.begin());
+            consider(tryOrder(e, order.data(), fieldLen, blockIntervalCounts, isLive, kept, removed));
+
+            consider(greedyOrder(e, givenOrder, fieldLen, blockIntervalCounts, isLive, kept, removed));
+
+            // seeded off the block so runs are repeatable.
+            mt19937 rng(b);
+            copy(givenOrder, givenOrder + fieldLen, order.begin());
+            for (int restart = 0; restart < REMOVAL_ORDER_RESTARTS; restart++) {
+                shuffle(order.begin(), order.end(), rng);
+                consider(tryOrder(e, order.data(), fieldLen, blockIntervalCounts, isLive, kept, removed));
+            }
+
+            for (int a = 0; a < fieldLen; a++) {
+                if (!bestRemoved[a])
+                    continue;
+                for (int i = 0; i < blockIntervalCounts[a]; i++) {
+                    blockMins[attrOffsets[a] + i] = 0.0f;
+                    blockMaxes[attrOffsets[a] + i] = 1.0f;
+                }
+                attrRemoveFlags[fieldLen * b + a] = 1;
+            }
+        }
+    }
+}
+
+// one interval per attribute. same engine, every attribute just has the one window.
+void removeUselessAttributesNoDisjunctionsCPU(float *mins, float *maxes, const int numBlocks, const int FIELD_LENGTH, const int *blockClasses, const float *dataset, const int numPoints, const int *classBorder, const int numClasses, const int *attributeOrder) {
+
+    const AttributeColumns columns = IntervalHyperBlock::separateByAttribute(dataset, numPoints, classBorder, numClasses, FIELD_LENGTH);
+
+    vector<int> offsets(FIELD_LENGTH);
+    vector<int> ones(FIELD_LENGTH, 1);
+    for (int a = 0; a < FIELD_LENGTH; a++)
+        offsets[a] = a;
+
+    #pragma omp parallel
+    {
+        BlockWindows w;
+        vector<int> survivors;
+        vector<uint64_t> bits((numPoints + 63) / 64, 0);
+
+        #pragma omp for schedule(dynamic)
+        for (int b = 0; b < numBlocks; b++) {
+            float *blockMins = &mins[(size_t)b * FIELD_LENGTH];
+            float *blockMaxes = &maxes[(size_t)b * FIELD_LENGTH];
+            const int classNum = blockClasses[b];
+            buildBlockWindows(columns, blockMins, blockMaxes, offsets.data(), ones.data(), FIELD_LENGTH, w);
+
+            for (int attrIdx = 0; attrIdx < FIELD_LENGTH; attrIdx++) {
+                const int attributeToRemove = attributeOrder[classNum * FIELD_LENGTH + attrIdx];
+
+                if (wrongClassInsideWithout(columns, dataset, FIELD_LENGTH, blockMins, blockMaxes, offsets.data(), ones.data(), w, attributeToRemove, classBorder[classNum], classBorder[classNum + 1], survivors, bits))
+                    continue;
+
+                blockMins[attributeToRemove] = 0.0f;
+                blockMaxes[attributeToRemove] = 1.0f;
+                windowsOfAttribute(columns, blockMins, blockMaxes, offsets.data(), ones.data(), attributeToRemove, w);
+                stable_sort(w.order.begin(), w.order.end(), [&](int x, int y) { return w.sizes[x] < w.sizes[y]; });
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+//
+// Created by Austin Snyder on 6/18/2025.
+//
+#pragma once
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+
+#ifndef MERGERHYPERBLOCKCPU_H
+#define MERGERHYPERBLOCKCPU_H
+
+// CPU versions of the merging kernels from MergerHyperBlock.cu. These take the exact same buffers as the kernels do,
+// padded mins/maxes (numAttributes is a multiple of 4), and the opposing points in the SoA float4 layout, where chunk i of
+// point p is the 4 floats starting at opposingPoints[(i * numPoints + p) * 4]. so CpuBackend and CudaBackend use the same opposing point layout.
+// results are identical to the kernels, the candidates are split across the OpenMP thread pool, and the point inside box
+// test uses AVX-512 or AVX2 when the machine has it (picked at runtime, scalar fallback otherwise).
+
+// run a wave of seeds at once. slot s is the seed at readSeedQueue[firstSeedIndex + s], waveMergable[s * numBlocks + candidate] gets whether
+// that candidate can eat it. doesn't write any bounds or flags. returns the first slot that merged (waveSize if none), the slots up to and
+// including it are exactly what mergerHyperBlocks would do one seed at a time, the rest get redone in the next wave.
+// tileMins/tileMaxes are the bounding boxes of each OPPOSING_TILE_SIZE run of points, a tile that misses the combined block is skipped whole.
+// witnesses is a ring of WITNESS_RING_SIZE opposing point indices per block (-1 for empty), witnessHeads the next spot to write in each.
+// they carry over between waves, so allocate them once per class.
+int mergerHyperBlocksWaveCPU(
+    const int firstSeedIndex, const int waveSize, const int *readSeedQueue, const int numBlocks,
+    const int numAttributes, const int numPoints, const float *opposingPoints,
+    const float *tileMins, const float *tileMaxes,
+    const float *hyperBlockMins, const float *hyperBlockMaxes, const int *deleteFlags, int *waveMergable,
+    int *witnesses, int *witnessHeads);
+
+// keeps slots [0, lastSlot] of a wave. kills their seeds, and if lastSlot merged, the candidates flagged in slotMergable take the combined bounds.
+void commitMergeWaveCPU(const int firstSeedIndex, const int lastSlot, const bool lastSlotMerged, const int *readSeedQueue, const int numBlocks, const int numAttributes, float *hyperBlockMins, float *hyperBlockMaxes, int *deleteFlags, const int *slotMergable);
+
+// merged blocks go to the back (reversed), the ones which didn't merge slide to the front. same as rearrangeSeedQueue.
+void rearrangeSeedQueueCPU(const int deadSeedNum, const int *readSeedQueue, int *writeSeedQueue, const int *mergable, const int numBlocks);
+
+// ------------------------ removing useless blocks. same 4 step chain as the kernels, ASSIGN -> SUM -> FIND BETTER -> SUM. -------------------------
+// blocks are in the flattenMinsMaxesForRUB encoding (count of intervals before each attribute), points are row major.
+
+// how many attributes the stabbing index cuts up, and how many buckets of points each one gets.
+#define STABBING_ATTRIBUTES 4
+#define STABBING_BUCKETS 256
+// below this many blocks the index isn't built.
+#define STABBING_MIN_BLOCKS 128
+
+// which blocks could possibly hold each point, so the kernels' walk over every block only has to look at those.
+// the STABBING_ATTRIBUTES attributes where the blocks are narrowest get their points cut into STABBING_BUCKETS equal buckets, and each bucket
+// keeps a bitset of the blocks which reach into it. a point's candidates are the AND of its buckets' bitsets, every block which holds the point is in there.
+class BlockStabbingIndex {
+public:
+    void build(const float *dataPointsArray, const int numAttributes, const int numPoints, const float *blockMins, const float *blockMaxes, const int *blockEdges, const int numBlocks);
+
+    // fills out (words() long) with the candidate blocks for point p, lowest block is bit 0.
+    void candidates(const int p, uint64_t *out) const;
+
+    int words() const { return numWords; }
+
+private:
+    int numWords = 0;
+    int numBuckets = 0;
+    int numPoints = 0;
+    std::vector<int> attributes;        // the indexed attributes
+    std::vector<int> bucketOfPoint;     // [k * numPoints + p], k being the k'th indexed attribute
+    std::vector<uint64_t> bits;         // [(k * numBuckets + bucket) * numWords + word]
+};
+
+void assignPointsToBlocksCPU(const float *dataPointsArray, const int numAttributes, const int numPoints, const float *blockMins, const float *blockMaxes, const int *blockEdges, const int numBlocks, const BlockStabbingIndex &index, int *dataPointBlocks);
+
+// points that didn't land in any block (-1) just don't get counted.
+void sumPointsPerBlockCPU(const int *dataPointBlocks, const int numPoints, int *numPointsInBlocks);
+
+void findBetterBlocksCPU(const float *dataPointsArray, const int numAttributes, const int numPoints, const float *blockMins, const float *blockMaxes, const int *blockEdges, const int numBlocks, const BlockStabbingIndex &index, int *dataPointBlocks, const int *numPointsInBlocks);
+
+// the same counts as ASSIGN -> SUM -> FIND BETTER -> SUM, but kept around between rounds of removeUselessBlocks so deleting blocks doesn't mean recounting.
+// every point keeps the list of blocks it is inside of, and every block the list of points inside it. deleting blocks only redoes
+// the points which were inside a deleted block, or inside a block whose first pass count changed because of it.
+// blocks are numbered by their position in the current list, which shifts down on removal exactly like erasing from the vector of blocks does.
+class BlockCoverage {
+public:
+    void build(const float *dataPointsArray, const int numAttributes, const int numPoints, const float *blockMins, const float *blockMaxes, const int *blockEdges, const int numBlocks);
+
+    // positions have to be sorted ascending.
+    void removeBlocks(const std::vector<int> &positions);
+
+    int numBlocks() const { return alive.size(); }
+
+    // how many points chose the block at this position, same as numPointsInBlocks from countPointsPerBlock.
+    int pointsIn(const int position) const { return finalCounts[alive[position]]; }
+
+private:
+    // first still alive block the point is inside of, -1 if none.
+    int firstBlock(const int p) const;
+    // starting from the first block, the later block with strictly more first pass points, like findBetterBlocks.
+    int betterBlock(const int p) const;
+
+    std::vector<int> alive;             // original block number at each position
+    std::vector<char> removed;          // by original block number
+    std::vector<int> pointStart;        // point p is inside of pointBlocks[pointStart[p] .. pointStart[p + 1]), ascending
+    std::vector<int> pointBlocks;
+    std::vector<int> blockStart;        // block b holds blockPoints[blockStart[b] .. blockStart[b + 1])
+    std::vector<int> blockPoints;
+    std::vector<int> firstChoice;       // by point, what ASSIGN picked
+    std::vector<int> finalChoice;       // by point, what FIND BETTER picked
+    std::vector<int> firstCounts;       // by original block number, the first SUM
+    std::vector<int> finalCounts;       // by original block number, the second SUM
+};
+
+// ------------------------ removing useless attributes -------------------------
+// these don't brute force the dataset like the kernels. the dataset gets sorted into columns once, and a block's wrong class points come from
+// intersecting its windows in those columns. same results as the kernels.
+// disjunction friendly one. same arguments as the kernel minus minMaxLen (blockEdges says where everything is) and checkOrder (no point loop to order),
+// dataset is row major.
+void removeUselessAttributesCPU(float* mins, float* maxes, const int* intervalCounts, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder);
+
+// how many shuffled removal orders each block tries on top of the given order, its reverse and the greedy one.
+#define REMOVAL_ORDER_RESTARTS 4
+
+// removeUselessAttributesCPU, but instead of only trying attributeOrder, every block tries several removal orders and keeps whichever takes out
+// the most clauses (ties go to attributeOrder, so it's never worse). the wrong class points each attribute keeps out are worked out once per block,
+// off the sorted columns, after that an order is just counting. same arguments, no checkOrder since no points get tested per order.
+void searchRemovalOrderingsCPU(float* mins, float* maxes, const int* intervalCounts, const int* blockEdges, const int numBlocks, const int* blockClasses, char* attrRemoveFlags, const int fieldLen, const float* dataset, const int numPoints, const int* classBorder, const int numClasses, const int *attributeOrder);
+
+// one interval per attribute. the kernel wants the dataset transposed for coalescing, on the CPU we want it row major, so this one takes it row major.
+void removeUselessAttributesNoDisjunctionsCPU(float *mins, float *maxes, const int numBlocks, const int FIELD_LENGTH, const int *blockClasses, const float *dataset, const int numPoints, const int *classBorder, const int numClasses, const int *attributeOrder);
+
+// which instruction set the point scan ended up using. "AVX-512", "AVX2" or "scalar". just for printing.
+const char* cpuMergerSimdLevel();
+
+#endif //MERGERHYPERBLOCKCPU_H
@@ -0,0 +1,561 @@
+#include "InferenceServer.h"
+#include "../data_utilities/DataUtil.h"
+#include "../classification_testing/HyperBlockModel.h"
+#include "../classification_testing/OneToOneModel.h"
+#include "../hyperblock/BlockBoxes.h"
+#include <omp.h>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+extern int FIELD_LENGTH;
+extern int NUM_CLASSES;
+
+// most points classified together when --batch isn't given.
+#define SERVER_DEFAULT_BATCH 64
+// under this many points in a batch, doing them on one thread beats waking the others up.
+#define SERVER_PARALLEL_MIN 16
+// how much we try to read off the connection at once.
+#define SERVER_READ_SIZE (1 << 16)
+
+#ifndef _WIN32
+
+struct ServerOptions {
+    string modelFile;
+    bool oneToOne = false;
+    string trainFile;
+    float fixedMax = 0.0f;
+    string socketPath;
+    bool binary = false;
+    int batch = SERVER_DEFAULT_BATCH;
+    int threads = 0;                // 0 until run() works out the default
+};
+
+// what one thread needs to classify with, made once per thread.
+struct ServerScratch {
+    HyperBlockModel::Scratch basic;
+    OneToOneModel::Scratch pairs;
+    vector<BlockInfo> blockHits;
+};
+
+// the loaded model. nothing in it changes after loading, so every thread and connection shares the one.
+struct ServedModel {
+    int fieldLength = 0;
+    int numClasses = 0;
+    vector<string> classNames;
+
+    bool normalize = false;
+    vector<float> minValues;
+    vector<float> maxValues;
+
+    bool oneToOne = false;
+    HyperBlockModel basic;
+    OneToOneModel pairs;
+
+    ServerScratch makeScratch() const {
+        ServerScratch scratch;
+        if (oneToOne)
+            scratch.pairs = OneToOneModel::Scratch(pairs);
+        else
+            scratch.basic = HyperBlockModel::Scratch(basic);
+        return scratch;
+    }
+
+    // the predicted class, -1 for none. hits gets the block numbers the point is in.
+    int classify(const float *point, ServerScratch &scratch, vector<int> &hits) const {
+        if (!oneToOne) {
+            scratch.blockHits.clear();
+            const int predicted = basic.predict(point, scratch.basic, &scratch.blockHits);
+            for (const BlockInfo &hit : scratch.blockHits)
+                hits.push_back(hit.blockIdx);
+            return predicted;
+        }
+
+        // every pair's blocks vote for their own class, same as evaluateOneToOneHyperBlocks.
+        return pairs.predict(point, scratch.pairs, &hits);
+    }
+};
+
+// a batch of points being classified together. everything in here gets reused batch after batch.
+struct Batch {
+    int count = 0;
+    vector<float> points;           // count * fieldLength
+    vector<char> valid;             // csv lines which didn't parse get an error back instead
+    vector<int> predicted;
+    vector<vector<int>> hits;
+
+    Batch(const ServedModel &model, int capacity) : points((size_t)capacity * model.fieldLength), valid(capacity), predicted(capacity), hits(capacity) {}
+};
+
+// threads is given every time, omp_set_num_threads wouldn't reach the connection threads. scratch needs one per thread.
+static void classifyBatch(const ServedModel &model, Batch &batch, vector<ServerScratch> &scratch, int threads) {
+    #pragma omp parallel for schedule(static) num_threads(threads) if(batch.count >= SERVER_PARALLEL_MIN)
+    for (int p = 0; p < batch.count; p++) {
+        batch.hits[p].clear();
+        if (!batch.valid[p])
+            continue;
+        float *point = &batch.points[(size_t)p * model.fieldLength];
+        if (model.normalize)
+            DataUtil::normalizePoint(point, model.minValues, model.maxValues, model.fieldLength);
+        batch.predicted[p] = model.classify(point, scratch[omp_get_thread_num()], batch.hits[p]);
+    }
+}
+
+// buffered reads straight off a file descriptor, so we can tell whether there's more input waiting without blocking on it.
+class FdReader {
+public:
+    explicit FdReader(int fd) : fd(fd), buffer(SERVER_READ_SIZE + 1) {}
+
+    // the next line, '\n' (and '\r') cut off and null terminated in place. false once the input is done.
+    bool nextLine(char *&line) {
+        for (;;) {
+            char *newline = static_cast<char*>(memchr(buffer.data() + begin, '\n', end - begin));
+            if (newline) {
+                *newline = '\0';
+                if (newline > buffer.data() + begin && newline[-1] == '\r')
+                    newline[-1] = '\0';
+                line = buffer.data() + begin;
+                begin = newline - buffer.data() + 1;
+                return true;
+            }
+            if (eof) {
+                if (begin == end)
+                    return false;
+                // last line without a newline on it.
+                buffer[end] = '\0';
+                line = buffer.data() + begin;
+                begin = end;
+                return true;
+            }
+            fill();
+        }
+    }
+
+    // exactly size bytes, false if the input ends first.
+    bool readExact(void *out, size_t size) {
+        char *to = static_cast<char*>(out);
+        while (size > 0) {
+            if (begin == end) {
+                if (eof)
+                    return false;
+                fill();
+                continue;
+            }
+            const size_t n = min(size, end - begin);
+            memcpy(to, buffer.data() + begin, n);
+            begin += n;
+            to += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    // whether another line is already here, or at least on its way, so batching it up won't leave the earlier points waiting.
+    bool lineReady() {
+        if (memchr(buffer.data() + begin, '\n', end - begin))
+            return true;
+        if (eof)
+            return begin != end;
+        pollfd waiting{fd, POLLIN, 0};
+        return poll(&waiting, 1, 0) > 0;
+    }
+
+private:
+    void fill() {
+        // move what's left to the front, and make room if one line is bigger than the whole buffer.
+        if (begin > 0) {
+            memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+        }
+        if (end + 1 >= buffer.size())
+            buffer.resize(buffer.size() * 2);
+
+        for (;;) {
+            const ssize_t n = read(fd, buffer.data() + end, buffer.size() - 1 - end);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                eof = true;
+            else
+                end += n;
+            return;
+        }
+    }
+
+    int fd;
+    vector<char> buffer;
+    size_t begin = 0;
+    size_t end = 0;
+    bool eof = false;
+};
+
+static bool writeAll(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        const ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+// the attribute values of one csv line into point. a class label on the end is fine, anything else wrong and it's not valid.
+static bool parseCsvPoint(char *line, float *point, int fieldLength) {
+    int field = 0;
+    char *at = line;
+    for (;;) {
+        char *comma = strchr(at, ',');
+        if (comma)
+            *comma = '\0';
+
+        if (field < fieldLength) {
+            char *parsedTo;
+            point[field] = strtof(at, &parsedTo);
+            while (*parsedTo == ' ' || *parsedTo == '\t')
+                parsedTo++;
+            if (parsedTo == at || *parsedTo != '\0')
+                return false;
+        }
+        field++;
+
+        if (!comma)
+            break;
+        at = comma + 1;
+    }
+    return field == fieldLength || field == fieldLength + 1;
+}
+
+static void appendInt(string &out, int value) {
+    char digits[16];
+    const auto result = to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+static void appendCsvResponses(const ServedModel &model, const Batch &batch, string &out) {
+    for (int p = 0; p < batch.count; p++) {
+        if (!batch.valid[p]) {
+            out += "error,expected ";
+            appendInt(out, model.fieldLength);
+            out += " attribute values,\n";
+            continue;
+        }
+
+        const int predicted = batch.predicted[p];
+        appendInt(out, predicted);
+        out += ',';
+        out += predicted == -1 ? "unclassified" : model.classNames[predicted];
+        out += ',';
+        for (size_t h = 0; h < batch.hits[p].size(); h++) {
+            if (h > 0)
+                out += ';';
+            appendInt(out, batch.hits[p][h]);
+        }
+        out += '\n';
+    }
+}
+
+static void appendBinaryInt(string &out, int32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(int32_t));
+}
+
+// csv lines in, a line back for each. points which are already waiting get classified together, up to the batch size.
+static void serveCsv(const ServedModel &model, const ServerOptions &options, int inFd, int outFd) {
+    FdReader reader(inFd);
+    Batch batch(model, options.batch);
+    vector<ServerScratch> scratch(options.threads, model.makeScratch());
+    string out;
+
+    auto respond = [&]() {
+        classifyBatch(model, batch, scratch, options.threads);
+        out.clear();
+        appendCsvResponses(model, batch, out);
+        batch.count = 0;
+        return writeAll(outFd, out.data(), out.size());
+    };
+
+    char *line;
+    while (reader.nextLine(line)) {
+        if (line[0] == '\0')
+            continue;
+
+        const int p = batch.count++;
+        batch.valid[p] = parseCsvPoint(line, &batch.points[(size_t)p * model.fieldLength], model.fieldLength);
+
+        if ((batch.count == options.batch || !reader.lineReady()) && !respond())
+            return;
+    }
+
+    // the input can end while we thought more was coming.
+    if (batch.count > 0)
+        respond();
+}
+
+// [int count][count points of floats] in, [int count] then [int class][int numHits][hits] back for each point. all in the host's byte order.
+static void serveBinary(const ServedModel &model, const ServerOptions &options, int inFd, int outFd) {
+    FdReader reader(inFd);
+    Batch batch(model, options.batch);
+    fill(batch.valid.begin(), batch.valid.end(), 1);
+    vector<ServerScratch> scratch(options.threads, model.makeScratch());
+    string out;
+
+    int32_t count;
+    while (reader.readExact(&count, sizeof(int32_t))) {
+        if (count < 0)
+            return;
+
+        out.clear();
+        appendBinaryInt(out, count);
+        for (int done = 0; done < count; done += batch.count) {
+            batch.count = min(options.batch, count - done);
+            if (!reader.readExact(batch.points.data(), (size_t)batch.count * model.fieldLength * sizeof(float)))
+                return;
+            classifyBatch(model, batch, scratch, options.threads);
+
+            for (int p = 0; p < batch.count; p++) {
+                appendBinaryInt(out, batch.predicted[p]);
+                appendBinaryInt(out, batch.hits[p].size());
+                out.append(reinterpret_cast<const char*>(batch.hits[p].data()), batch.hits[p].size() * sizeof(int32_t));
+            }
+        }
+        if (!writeAll(outFd, out.data(), out.size()))
+            return;
+    }
+}
+
+static void serveConnection(const ServedModel &model, const ServerOptions &options, int inFd, int outFd) {
+    if (options.binary)
+        serveBinary(model, options, inFd, outFd);
+    else
+        serveCsv(model, options, inFd, outFd);
+}
+
+static int serveSocket(const ServedModel &model, const ServerOptions &options) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (options.socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "Socket path is too long: " << options.socketPath << endl;
+        return 1;
+    }
+    strcpy(address.sun_path, options.socketPath.c_str());
+
+    const int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(options.socketPath.c_str());
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listenFd, SOMAXCONN) < 0) {
+        cerr << "Couldn't listen on " << options.socketPath << ": " << strerror(errno) << endl;
+        return 1;
+    }
+    cerr << "Listening on " << options.socketPath << endl;
+
+    for (;;) {
+        const int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            cerr << "accept failed: " << strerror(errno) << endl;
+            close(listenFd);
+            return 1;
+        }
+
+        thread([&model, &options, fd]() {
+            serveConnection(model, options, fd, fd);
+            close(fd);
+        }).detach();
+    }
+}
+
+static bool loadModel(const ServerOptions &options, ServedModel &model) {
+    vector<HyperBlock> blocks;
+    vector<vector<HyperBlock>> pairSets;
+    vector<pair<int, int>> pairs;
+    int maxClass = -1;
+
+    model.oneToOne = options.oneToOne;
+    if (options.oneToOne) {
+        pairSets = DataUtil::loadOneToOneHBsFromBinary(options.modelFile, pairs);
+        for (const auto &set : pairSets)
+            for (const HyperBlock &hb : set) {
+                model.fieldLength = hb.maximums.size();
+                maxClass = max(maxClass, hb.classNum);
+            }
+        for (const auto &classes : pairs)
+            maxClass = max(maxClass, max(classes.first, classes.second));
+    }
+    else {
+        blocks = DataUtil::loadBasicHBsFromBinary(options.modelFile);
+        for (const HyperBlock &hb : blocks) {
+            model.fieldLength = hb.maximums.size();
+            maxClass = max(maxClass, hb.classNum);
+        }
+    }
+
+    if (model.fieldLength == 0) {
+        cerr << "No blocks in " << options.modelFile << endl;
+        return false;
+    }
+    model.numClasses = maxClass + 1;
+
+    map<int, string> classNames;
+    if (!options.trainFile.empty()) {
+        map<string, int> classMap;
+        vector<vector<vector<float>>> trainingData = DataUtil::dataSetup(options.trainFile, classMap, classNames);
+        if (trainingData.empty())
+            return false;
+        if (FIELD_LENGTH != model.fieldLength) {
+            cerr << "The training data has " << FIELD_LENGTH << " attributes, the model has " << model.fieldLength << endl;
+            return false;
+        }
+        model.numClasses = max(model.numClasses, NUM_CLASSES);
+
+        model.normalize = true;
+        model.minValues.assign(model.fieldLength, numeric_limits<float>::infinity());
+        model.maxValues.assign(model.fieldLength, -numeric_limits<float>::infinity());
+        DataUtil::findMinMaxValuesInDataset(trainingData, model.minValues, model.maxValues, model.fieldLength);
+    }
+    else if (options.fixedMax > 0.0f) {
+        model.normalize = true;
+        model.minValues.assign(model.fieldLength, 0.0f);
+        model.maxValues.assign(model.fieldLength, options.fixedMax);
+    }
+
+    for (int cls = 0; cls < model.numClasses; cls++)
+        model.classNames.push_back(classNames.count(cls) ? classNames[cls] : to_string(cls));
+
+    if (!options.oneToOne) {
+        // the hits are reported as where the block is in the file.
+        for (int b = 0; b < (int)blocks.size(); b++)
+            blocks[b].blockId = b;
+        model.basic = HyperBlockModel(blocks, model.fieldLength, model.numClasses);
+        cerr << "Loaded " << blocks.size() << " blocks";
+    }
+    else {
+        model.pairs = OneToOneModel(pairSets, pairs, model.fieldLength, model.numClasses);
+        for (const auto &missing : model.pairs.missingPairs())
+            cerr << "Warning: no block set for classes " << missing.first << " and " << missing.second << endl;
+        if (model.pairs.missingPairs().size() == (size_t)model.numClasses * (model.numClasses - 1) / 2) {
+            cerr << "No usable class pairs in " << options.modelFile << endl;
+            return false;
+        }
+
+        int totalBlocks = 0;
+        for (const auto &set : pairSets)
+            totalBlocks += set.size();
+        cerr << "Loaded " << totalBlocks << " one to one blocks in " << pairSets.size() << " sets";
+    }
+    cerr << ", " << model.fieldLength << " attributes, " << model.numClasses << " classes, " << BlockBoxes::simdLevel() << " box tests" << endl;
+    return true;
+}
+
+static void printUsage() {
+    cerr << "Usage: Hyperblocks --serve <model.bin> [--one-to-one] [--train <training.csv> | --max <value>] [--socket <path>] [--binary] [--batch <n>] [--threads <n>]" << endl;
+}
+
+// all of text has to be the number, false for anything else.
+static bool parseInt(const char *text, int &value) {
+    char *parsedTo;
+    errno = 0;
+    const long parsed = strtol(text, &parsedTo, 10);
+    if (parsedTo == text || *parsedTo != '\0' || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX)
+        return false;
+    value = parsed;
+    return true;
+}
+
+static bool parseFloat(const char *text, float &value) {
+    char *parsedTo;
+    errno = 0;
+    const float parsed = strtof(text, &parsedTo);
+    if (parsedTo == text || *parsedTo != '\0' || errno == ERANGE)
+        return false;
+    value = parsed;
+    return true;
+}
+
+static int badValue(const string &option, const char *value) {
+    cerr << "Not a valid number for " << option << ": " << value << endl;
+    printUsage();
+    return 1;
+}
+
+int InferenceServer::run(int argc, char* argv[]) {
+    ServerOptions options;
+    for (int i = 2; i < argc; i++) {
+        const string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--one-to-one")
+            options.oneToOne = true;
+        else if (arg == "--binary")
+            options.binary = true;
+        else if (arg == "--train" && hasValue)
+            options.trainFile = argv[++i];
+        else if (arg == "--max" && hasValue) {
+            if (!parseFloat(argv[++i], options.fixedMax))
+                return badValue(arg, argv[i]);
+        }
+        else if (arg == "--socket" && hasValue)
+            options.socketPath = argv[++i];
+        else if (arg == "--batch" && hasValue) {
+            if (!parseInt(argv[++i], options.batch))
+                return badValue(arg, argv[i]);
+            options.batch = max(1, options.batch);
+        }
+        else if (arg == "--threads" && hasValue) {
+            if (!parseInt(argv[++i], options.threads))
+                return badValue(arg, argv[i]);
+        }
+        else if (arg[0] != '-' && options.modelFile.empty())
+            options.modelFile = arg;
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (options.modelFile.empty()) {
+        printUsage();
+        return 1;
+    }
+    if (options.threads <= 0)
+        options.threads = omp_get_max_threads();
+
+    ServedModel model;
+    if (!loadModel(options, model))
+        return 1;
+
+    // a client hanging up shouldn't take the whole server down with it.
+    signal(SIGPIPE, SIG_IGN);
+
+    if (!options.socketPath.empty())
+        return serveSocket(model, options);
+
+    serveConnection(model, options, STDIN_FILENO, STDOUT_FILENO);
+    return 0;
+}
+
+#else
+
+int InferenceServer::run(int argc, char* argv[]) {
+    cerr << "Server mode needs a POSIX system (unix sockets and poll)" << endl;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+
+#ifndef INFERENCESERVER_H
+#define INFERENCESERVER_H
+
+using namespace std;
+
+/**
+ * Server mode. Loads a saved model once, then classifies points as they come in over stdin or a unix socket, instead of going through the menu.
+ *
+ *   Hyperblocks --serve <model.bin> [--one-to-one] [--train <training.csv> | --max <value>] [--socket <path>] [--binary] [--batch <n>] [--threads <n>]
+ *
+ * --one-to-one     the model is saveOneToOneHBsToBinary output instead of saveBasicHBsToBinary
+ * --train          the training csv the model was made from. its min and max normalize the incoming points, same as normalizeTestSet, and its class names get used
+ * --max            normalize by a fixed max instead (min of 0), like menu option 2. with neither the points are used as they are
+ * --socket         listen on a unix socket instead of stdin/stdout, every connection gets its own thread
+ * --binary         binary requests instead of csv lines, see below
+ * --batch          most points classified together, default SERVER_DEFAULT_BATCH. points which are already waiting get batched, we never wait for more
+ * --threads        OpenMP threads a batch gets split across, default omp_get_max_threads(). every connection's batches get this many
+ *
+ * csv: one point per line, the attribute values split by commas (a class label on the end is fine, it gets ignored). every line that isn't blank gets
+ *      one line back, "class index,class name,blocks" with the block numbers the point is in split by ';'. -1 and "unclassified" for a point in no block
+ *      or a tie, "error,..." for a line that didn't parse.
+ * binary: [int count][count * attributes floats] in, [int count] then [int class][int numHits][numHits ints] for each point back. all 32 bit, in the
+ *         host's byte order, nothing gets swapped. the client is on the same machine (stdin or a unix socket), so it just writes its own ints and floats.
+ */
+class InferenceServer {
+public:
+    static int run(int argc, char* argv[]);
+};
+
+#endif //INFERENCESERVER_H
@@ -4,13 +4,36 @@
 #ifndef DATAATTR_H
 #define DATAATTR_H
 
-// Struct version of DataATTR xrecord
+#include <vector>
+
+// one value of one point, in one of the sorted attribute columns. just the value and the point's global id, so an entry is 8 bytes.
+// the global id is classOffsets[classNum] + classIndex, everything else about the point is stored once in AttributeColumns instead of once per column.
 struct DataATTR {
     float value; // Value of one attribute of a point
-    int classNum; // The class number of the point
-    int classIndex; // The index of point within the class
-    bool used;
-    DataATTR(float val, int cls, int index, bool beenUsed) : value(val), classNum(cls), classIndex(index), used(beenUsed){}
+    int id;      // global id of the point
+    DataATTR() = default;
+    DataATTR(float val, int pointId) : value(val), id(pointId) {}
+};
+
+// the training data broken up by attribute (separateByAttribute). every column has every point, sorted by value.
+// indexing it gives you a column, like the old vector<vector<DataATTR>> did.
+struct AttributeColumns {
+    std::vector<std::vector<DataATTR>> columns;
+
+    std::vector<int> classOffsets;  // first global id of each class, plus the total on the end. class c is [classOffsets[c], classOffsets[c + 1])
+    std::vector<int> classOf;       // by global id
+    std::vector<int> indexInClass;  // by global id
+    std::vector<char> used;         // by global id, whether the point has gone into a block yet
+
+    size_t size() const { return columns.size(); }
+    std::vector<DataATTR>& operator[](size_t attribute) { return columns[attribute]; }
+    const std::vector<DataATTR>& operator[](size_t attribute) const { return columns[attribute]; }
+
+    int numPoints() const { return classOffsets.empty() ? 0 : classOffsets.back(); }
+    int classNum(const DataATTR &d) const { return classOf[d.id]; }
+    int classIndex(const DataATTR &d) const { return indexInClass[d.id]; }
+    bool inClass(const DataATTR &d, int classNum) const { return d.id >= classOffsets[classNum] && d.id < classOffsets[classNum + 1]; }
+    bool isUsed(const DataATTR &d) const { return used[d.id]; }
 };
 
 #endif //DATAATTR_H
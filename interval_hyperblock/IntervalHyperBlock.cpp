@@ -0,0 +1,1802 @@
+//
+// Created by Austin Snyder on 3/20/2025.
+//
+#include "IntervalHyperBlock.h"
+#include "../hyperblock/BlockBoxes.h"
+using namespace std;
+
+
+#define EPSILON 1e-6 // comparing float helper
+
+static bool closeEnough(float a, float b) {
+    return abs(a - b) < EPSILON;
+}
+
+// the tie groups of one sorted column, worked out once so the interval checks below don't have to walk over runs of equal values.
+// binary and pixel features are mostly duplicates, and walking those over and over for every start was quadratic.
+// "same value" is closeEnough to the value we're looking from, and since the column is sorted, the entries which are the same value as
+// entry i and behind it are always one contiguous stretch. same for the ones the same as i + 1, ending at i.
+struct IntervalHyperBlock::ColumnTies {
+    vector<int> classes;      // class of each entry, in column order
+    vector<int> runEnd;       // last entry of the same class run entry i is in
+    vector<char> validStart;  // checkValidStart: no wrong class entry behind i with the same value as i
+    vector<int> validFrom;    // lowest b where validStart is true all the way from b to i. only meaningful when validStart[i]
+    vector<int> tieStart;     // lowest k where entries k..i all have the same value as entry i + 1. i + 1 if entry i doesn't
+    vector<int> unusedBefore; // unused entries in [0, i), for the fresh point counts. taken when the ties are built.
+
+    void build(const AttributeColumns &columns, int attribute) {
+        const vector<DataATTR> &column = columns[attribute];
+        const int n = column.size();
+        classes.resize(n);
+        runEnd.resize(n);
+        validStart.resize(n);
+        validFrom.resize(n);
+        tieStart.resize(n);
+        unusedBefore.resize(n + 1);
+
+        unusedBefore[0] = 0;
+        for (int i = 0; i < n; i++) {
+            classes[i] = columns.classOf[column[i].id];
+            unusedBefore[i + 1] = unusedBefore[i] + !columns.used[column[i].id];
+        }
+
+        for (int i = n - 1; i >= 0; i--)
+            runEnd[i] = (i + 1 < n && classes[i + 1] == classes[i]) ? runEnd[i + 1] : i;
+
+        // sameFrom only moves forward, since the values only go up. nearestOtherClass is the last entry behind i which isn't i's class.
+        int sameFrom = 0;
+        int nearestOtherClass = -1;
+        for (int i = 0; i < n; i++) {
+            if (i > 0 && classes[i - 1] != classes[i])
+                nearestOtherClass = i - 1;
+            while (sameFrom < i && !closeEnough(column[sameFrom].value, column[i].value))
+                sameFrom++;
+            validStart[i] = !(nearestOtherClass >= sameFrom);
+            validFrom[i] = (i > 0 && validStart[i - 1]) ? validFrom[i - 1] : i;
+        }
+
+        int tieFrom = 0;
+        for (int i = 0; i < n; i++) {
+            if (i + 1 == n) {
+                tieStart[i] = i + 1;
+                break;
+            }
+            while (tieFrom <= i && !closeEnough(column[tieFrom].value, column[i + 1].value))
+                tieFrom++;
+            tieStart[i] = tieFrom;
+        }
+    }
+
+    int unusedIn(int first, int last) const {
+        return last < first ? 0 : unusedBefore[last + 1] - unusedBefore[first];
+    }
+};
+using ColumnTies = IntervalHyperBlock::ColumnTies;
+
+// sorts one column by value only. std::sort isn't stable, so the order tied values come out in is whatever the sort leaves them in, and the
+// interval search and the merging see the ties in that order. a stable (or radix) sort puts them in id order instead, which makes different blocks.
+static void sortColumn(vector<DataATTR> &column) {
+    sort(column.begin(), column.end(), [](const DataATTR &a, const DataATTR &b) {
+        return a.value < b.value;
+    });
+}
+
+// helper function. checks if there are any of the exact same value that our current start of an interval has, of the wrong class behind it
+// basically tells us whether or not an index is a valid place we can start an interval from
+static bool checkValidStart(const ColumnTies &ties, int currentStart) {
+    return ties.validStart[currentStart];
+}
+
+// helper function. returns how many indexes we can move forward while still maintaining the integrity of our pure interval, and
+// also returns the count of points which we are using for the first time in this interval. Meaning the count of previously unused points.
+static pair<int, int> checkForwards(const ColumnTies &ties, int currentStart, int targetClass) {
+    const int n = ties.classes.size();
+
+    // jump to the end of the run of targetClass entries right after us.
+    int end = (currentStart + 1 < n && ties.classes[currentStart + 1] == targetClass) ? ties.runEnd[currentStart + 1] : currentStart;
+
+    // If the next item (end+1) is a DIFFERENT class with the SAME-ISH value as the tail, we must trim off the
+    // last items with that value, because that attribute value is "shared" by a different class.
+    if (end + 1 < n && ties.classes[end + 1] != targetClass) {
+        end = min(end, ties.tieStart[end] - 1);
+    }
+
+    if (end < currentStart) {
+        // means the conflict happened right away,
+        // so the valid interval is effectively just "start" itself or empty.
+        return {currentStart, 0};
+    }
+
+    // we need to return how many points we are using for the first time. This a better indicator of size for an interval.
+    // it could be 50 points long interval, but 49 are used, that is not going to speed up the removal process much.
+    return {end, ties.unusedIn(currentStart + 1, end)};
+}
+
+static pair <int, int> checkBackwards(const ColumnTies &ties, int currentStart, int targetClass) {
+
+    if (!checkValidStart(ties, currentStart)) {
+        return {currentStart, 0};
+    }
+
+    // extend down while we legally can, which is the whole stretch of valid starts we're in.
+    const int beg = ties.validFrom[currentStart];
+
+    // no trimming step here – if we ever hit a conflict, we’d have caught it in step 0
+    return { beg, ties.unusedIn(beg, currentStart - 1) };
+}
+
+// how many blocks uncontainedBlocks checks against the kept set at once. the chunk is checked in parallel, then settled amongst itself.
+#define CONTAINMENT_CHUNK 256
+
+// keep flags for blocks with one interval per attribute: a block goes if some other block contains it (bounds inclusive). of identical blocks, the lowest index stays.
+// a block can only be inside one whose widths are all at least as big, so the summed width is too. we go widest first, and each block only
+// needs checking against the blocks kept so far: if something contains it, then so does a kept block (whatever contains that one, and so on).
+// so it's blocks * kept blocks instead of blocks * blocks, and the seeds of one pure region mostly land inside the same few blocks.
+static vector<char> uncontainedBlocks(const vector<HyperBlock> &blocks, int FIELD_LENGTH) {
+    const int nBlocks = blocks.size();
+    vector<char> keep(nBlocks, 0);
+
+    // flat bounds so the scans below are contiguous.
+    vector<float> mins((size_t)nBlocks * FIELD_LENGTH);
+    vector<float> maxes((size_t)nBlocks * FIELD_LENGTH);
+    vector<double> widthSums(nBlocks, 0.0);
+    #pragma omp parallel for schedule(static)
+    for (int b = 0; b < nBlocks; b++) {
+        for (int d = 0; d < FIELD_LENGTH; d++) {
+            mins[(size_t)b * FIELD_LENGTH + d] = blocks[b].minimums[d][0];
+            maxes[(size_t)b * FIELD_LENGTH + d] = blocks[b].maximums[d][0];
+            widthSums[b] += maxes[(size_t)b * FIELD_LENGTH + d] - mins[(size_t)b * FIELD_LENGTH + d];
+        }
+    }
+
+    // widest first. the rounding can give a container the same sum as a block inside it, so ties go lowest mins first, then highest maxes,
+    // which always puts the container in front. identical blocks are left in index order, so the first one is the one which gets kept.
+    vector<int> order(nBlocks);
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        if (widthSums[a] != widthSums[b])
+            return widthSums[a] > widthSums[b];
+        for (int d = 0; d < FIELD_LENGTH; d++) {
+            const float minA = mins[(size_t)a * FIELD_LENGTH + d], minB = mins[(size_t)b * FIELD_LENGTH + d];
+            if (minA != minB)
+                return minA < minB;
+        }
+        for (int d = 0; d < FIELD_LENGTH; d++) {
+            const float maxA = maxes[(size_t)a * FIELD_LENGTH + d], maxB = maxes[(size_t)b * FIELD_LENGTH + d];
+            if (maxA != maxB)
+                return maxA > maxB;
+        }
+        return a < b;
+    });
+
+    auto contains = [&](int big, int small) {
+        const float *bigMins = &mins[(size_t)big * FIELD_LENGTH];
+        const float *bigMaxes = &maxes[(size_t)big * FIELD_LENGTH];
+        const float *smallMins = &mins[(size_t)small * FIELD_LENGTH];
+        const float *smallMaxes = &maxes[(size_t)small * FIELD_LENGTH];
+        for (int d = 0; d < FIELD_LENGTH; d++) {
+            if (bigMaxes[d] < smallMaxes[d] || bigMins[d] > smallMins[d])
+                return false;
+        }
+        return true;
+    };
+
+    vector<int> kept;
+    vector<char> covered(CONTAINMENT_CHUNK);
+    for (int chunkStart = 0; chunkStart < nBlocks; chunkStart += CONTAINMENT_CHUNK) {
+        const int chunkSize = min(CONTAINMENT_CHUNK, nBlocks - chunkStart);
+        const int numKept = kept.size();
+
+        // against everything kept from the earlier chunks, nobody writes to kept in here.
+        #pragma omp parallel for schedule(dynamic, 8)
+        for (int c = 0; c < chunkSize; c++) {
+            const int small = order[chunkStart + c];
+            covered[c] = 0;
+            for (int k = 0; k < numKept; k++) {
+                if (contains(kept[k], small)) {
+                    covered[c] = 1;
+                    break;
+                }
+            }
+        }
+
+        // then against whatever this chunk has kept so far.
+        for (int c = 0; c < chunkSize; c++) {
+            if (covered[c])
+                continue;
+            const int small = order[chunkStart + c];
+            bool inside = false;
+            for (int k = numKept; k < (int)kept.size() && !inside; k++) {
+                inside = contains(kept[k], small);
+            }
+            if (!inside) {
+                kept.push_back(small);
+                keep[small] = 1;
+            }
+        }
+    }
+    return keep;
+}
+
+// generate a HB from each seed case, we simply make a block of the pure attribute around each attribute of each case.
+// so we would generate a block from each case, and then we end up merging them all.
+// Assumes ‑std=c++17 and OpenMP enabled (‑fopenmp / /openmp)
+void IntervalHyperBlock::pureBlockIntervalHyper(AttributeColumns &dataByAttribute, vector<vector<vector<float>>> &trainingData,vector<HyperBlock> &hyperBlocks,int COMMAND_LINE_ARGS_CLASS) {
+    const int FIELD_LENGTH = dataByAttribute.size();
+    bool doOneClass = (COMMAND_LINE_ARGS_CLASS != -1);
+
+    // every seed expands in every column, so work out the tie groups of each column once up front.
+    vector<ColumnTies> columnTies(FIELD_LENGTH);
+    #pragma omp parallel for schedule(dynamic)
+    for (int d = 0; d < FIELD_LENGTH; ++d) {
+        columnTies[d].build(dataByAttribute, d);
+    }
+
+    for (int classification = 0; classification < trainingData.size(); classification++) {
+
+        if (doOneClass && classification != COMMAND_LINE_ARGS_CLASS)
+            continue;
+
+        // go through each point
+        #pragma omp parallel for schedule(static)
+        for (int point = 0; point < trainingData[classification].size(); ++point) {
+            /* 2 · containers to remember where the seed sits in every column   */
+            vector<int> attrPos (FIELD_LENGTH, -1);   // index inside column
+            vector<float> lower (FIELD_LENGTH);       // placeholder for bounds
+            vector<float> upper (FIELD_LENGTH);
+
+            /* 3 · binary‑search each attribute column ------------------------*/
+            for (int d = 0; d < FIELD_LENGTH; ++d) {
+
+                const float seedVal = trainingData[classification][point][d];
+                auto &column = dataByAttribute[d];
+
+                /* lower_bound on value (columns already sorted by value) */
+                auto it = lower_bound(column.begin(), column.end(), seedVal, [](const DataATTR &a, float v){ return a.value < v; });
+
+                /* Walk forward over duplicates until we match the seed's global id */
+                const int seedId = dataByAttribute.classOffsets[classification] + point;
+                while (it != column.end() && it->value != seedVal && it->id != seedId) {
+                    ++it;
+                }
+
+                // track where we are in each column
+                attrPos[d] = static_cast<int>(distance(column.begin(), it));
+
+                // now our checking up and down
+                int upperIndex = checkForwards(columnTies[d], attrPos[d], classification).first;
+
+                int lowerIndex = checkBackwards(columnTies[d], attrPos[d], classification).first;
+
+                // set up our bounds with the values of furthest we can expand in each attribute
+                lower[d] = column[lowerIndex].value;
+                upper[d] = column[upperIndex].value;
+            }
+
+            // make a block out of the bounds we have just found
+            vector<vector<float>> maxes(dataByAttribute.size(), vector<float>(1, -numeric_limits<float>::infinity()));
+            vector<vector<float>> mins(dataByAttribute.size(), vector<float>(1, numeric_limits<float>::infinity()));
+            for (int attribute = 0; attribute < FIELD_LENGTH; attribute++) {
+                mins[attribute][0] = lower[attribute];
+                maxes[attribute][0] = upper[attribute];
+            }
+
+            HyperBlock block(maxes, mins, classification);
+
+            #pragma omp critical
+            hyperBlocks.emplace_back(move(block));
+        }
+    }
+
+    // now we go through and for each block we just check if the block is all the way inside another block already, if so we are going to remove it.
+    // of a bunch of identical blocks, the first one stays.
+    const int nBlocks = hyperBlocks.size();
+    vector<char> keep = uncontainedBlocks(hyperBlocks, FIELD_LENGTH);
+
+    int w = 0;
+    for (int r = 0; r < nBlocks; ++r)
+        if (keep[r]) {
+            if (w != r) // ← guard against self-move
+                hyperBlocks[w] = move(hyperBlocks[r]);
+            ++w;
+        }
+    hyperBlocks.erase(hyperBlocks.begin() + w, hyperBlocks.end());
+
+}
+
+// how many times a thread spins on the round barrier before it gives up and sleeps on the condition variable.
+// rounds are usually short (one block per round), so most of the time somebody shows up while we are still spinning.
+#define BARRIER_SPINS 4096
+
+static inline void spinPause() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#endif
+}
+
+// reusable barrier for the supervisor and workers. everybody spins for a bit, and only if the round is still not over do they park
+// on the condition variable. the last one in bumps the generation, which is what everybody is waiting on.
+class RoundBarrier {
+public:
+    explicit RoundBarrier(int parties) : parties(parties) {}
+
+    void arriveAndWait() {
+        const unsigned gen = generation.load(memory_order_acquire);
+
+        // last one in resets the count for the next round and lets everybody go.
+        if (waiting.fetch_add(1, memory_order_acq_rel) == parties - 1) {
+            waiting.store(0, memory_order_relaxed);
+            {
+                lock_guard<mutex> lock(parkLock);
+                generation.store(gen + 1, memory_order_release);
+            }
+            parked.notify_all();
+            return;
+        }
+
+        for (int spin = 0; spin < BARRIER_SPINS; spin++) {
+            if (generation.load(memory_order_acquire) != gen)
+                return;
+            spinPause();
+        }
+
+        unique_lock<mutex> lock(parkLock);
+        parked.wait(lock, [&]() { return generation.load(memory_order_acquire) != gen; });
+    }
+
+private:
+    const int parties;
+    atomic<int> waiting{0};
+    atomic<unsigned> generation{0};
+    mutex parkLock;
+    condition_variable parked;
+};
+
+// the same-class runs of one sorted column, and how many unused points each one would give an interval right now.
+// this is everything the old rescan of the column worked out every round, except the unused counts, which are the only thing which changes.
+//   - where a run's interval can start is fixed. checkValidStart only cares about values and classes, which never change, so it's the
+//     first entry of the run which doesn't share a value with a wrong class point behind it.
+//   - where it ends is fixed too. checkForwards trims off the tail which shares a value with the next run.
+//   - the interval itself doesn't count its own first point (checkForwards never did), so its size is unused - 1.
+// the runs sit under a little max segment tree, so marking a point used is a log(runs) update and the column's best interval is the root.
+struct ColumnRuns {
+    vector<int> first;      // first entry an interval in this run can use
+    vector<int> last;       // last entry, after trimming
+    vector<int> unused;     // unused points in [first, last]
+    vector<int> runOfPoint; // by global point id. -1 if the point isn't inside any run's [first, last]
+    vector<int> tree;       // run index with the most unused points under each node, leftmost on ties. -1 for nothing.
+    int leaves = 0;
+
+    int better(int a, int b) const {
+        if (a == -1) return b;
+        if (b == -1) return a;
+        return unused[b] > unused[a] ? b : a;
+    }
+
+    void build(const vector<DataATTR> &column, const ColumnTies &ties, int numPoints, int onlyClass) {
+        const int n = column.size();
+        runOfPoint.assign(numPoints, -1);
+
+        for (int a = 0; a < n; a = ties.runEnd[a] + 1) {
+            const int b = ties.runEnd[a];
+
+            // doing one class, so the wrong class runs are only there to block.
+            if (onlyClass == -1 || ties.classes[a] == onlyClass) {
+                int start = a;
+                while (start <= b && !ties.validStart[start])
+                    start++;
+
+                const int end = (b + 1 < n) ? max(ties.tieStart[b], a) - 1 : b;
+
+                if (start <= end) {
+                    const int run = first.size();
+                    first.push_back(start);
+                    last.push_back(end);
+                    unused.push_back(end - start + 1);
+                    for (int i = start; i <= end; i++)
+                        runOfPoint[column[i].id] = run;
+                }
+            }
+        }
+
+        leaves = 1;
+        while (leaves < (int)first.size())
+            leaves <<= 1;
+        tree.assign(2 * leaves, -1);
+        for (int run = 0; run < (int)first.size(); run++)
+            tree[leaves + run] = run;
+        for (int node = leaves - 1; node >= 1; node--)
+            tree[node] = better(tree[2 * node], tree[2 * node + 1]);
+    }
+
+    void markUsed(int pointId) {
+        const int run = runOfPoint[pointId];
+        if (run == -1)
+            return;
+        unused[run]--;
+        for (int node = (leaves + run) >> 1; node >= 1; node >>= 1)
+            tree[node] = better(tree[2 * node], tree[2 * node + 1]);
+    }
+
+    // best run in the whole column, -1 if there are no runs at all.
+    int best() const {
+        return tree.empty() ? -1 : tree[1];
+    }
+};
+
+// everything the supervisor and workers share. the supervisor only writes to it between rounds, while the workers are stuck at the barrier,
+// so the barrier is the only synchronization the marking needs.
+struct IntervalHyperBlock::RoundState {
+
+    // one of these per worker, on their own cache lines. a worker takes columns off its own range first, then steals off the others' ranges.
+    struct alignas(64) ColumnRange {
+        atomic<int> next{0};
+        int end = 0;
+    };
+
+    RoundState(int numWorkers, int numColumns, int numPoints) : barrier(numWorkers), ranges(numWorkers), numPoints(numPoints),
+        columnBest(numColumns, Interval(-1, -1, -1, -1, -1)), doneColumns(numColumns, 0), runs(numColumns), usedBits((numPoints + 63) / 64, 0) {}
+
+    RoundBarrier barrier;
+    vector<ColumnRange> ranges;
+    int numPoints;
+
+    // the columns which still have an interval in them, split evenly between the workers at the start of every round.
+    vector<int> liveColumns;
+
+    vector<Interval> columnBest;
+    vector<char> doneColumns;
+    vector<ColumnRuns> runs;
+
+    // bit id is set once that point is in a block. only ever gains bits.
+    vector<uint64_t> usedBits;
+
+    // the points the last round's block took, every column takes them out of its run counts.
+    vector<int> newlyUsed;
+
+    bool stop = false;
+
+    bool isUsed(const DataATTR &d) const {
+        const int id = d.id;
+        return (usedBits[id >> 6] >> (id & 63)) & 1ULL;
+    }
+
+    void markUsed(const DataATTR &d) {
+        const int id = d.id;
+        usedBits[id >> 6] |= 1ULL << (id & 63);
+        newlyUsed.push_back(id);
+    }
+
+    // split the live columns into one contiguous range per worker.
+    void dealColumns() {
+        const int numWorkers = ranges.size();
+        const int numLive = liveColumns.size();
+        for (int w = 0; w < numWorkers; w++) {
+            ranges[w].next.store((int)((long long)numLive * w / numWorkers), memory_order_relaxed);
+            ranges[w].end = (int)((long long)numLive * (w + 1) / numWorkers);
+        }
+    }
+
+    // next column for worker self, or -1 once every range is empty. own range first, then everybody else's.
+    int takeColumn(int self) {
+        const int numWorkers = ranges.size();
+        for (int k = 0; k < numWorkers; k++) {
+            ColumnRange &range = ranges[(self + k) % numWorkers];
+            if (range.next.load(memory_order_relaxed) >= range.end)
+                continue;
+            const int slot = range.next.fetch_add(1, memory_order_relaxed);
+            if (slot < range.end)
+                return liveColumns[slot];
+        }
+        return -1;
+    }
+};
+
+// worker function. every round, the workers pull columns (stealing when their own run out), take the points the last block used out of
+// that column's run counts, and read off the column's longest pure interval. the first round builds the runs. the supervisor picks the best
+// one out of all the columns between rounds. the supervisor is worker 0 and does its share of columns too, the others are threads which live for the whole generation.
+void IntervalHyperBlock::intervalHyperWorker(AttributeColumns &attributeColumns, RoundState &state, int threadID, int COMMAND_LINE_ARGS_CLASS) {
+
+    Interval emptyInterval(-1,-1,-1,-1,-1);
+
+    for (int column = state.takeColumn(threadID); column != -1; column = state.takeColumn(threadID)) {
+        ColumnRuns &runs = state.runs[column];
+
+        if (runs.tree.empty()) {
+            ColumnTies ties;
+            ties.build(attributeColumns, column);
+            runs.build(attributeColumns[column], ties, state.numPoints, COMMAND_LINE_ARGS_CLASS);
+        }
+        else {
+            for (int id : state.newlyUsed)
+                runs.markUsed(id);
+        }
+
+        // the interval doesn't count its first point, so it's one less than the run's unused count.
+        Interval columnBestInterval = emptyInterval;
+        const int best = runs.best();
+        if (best != -1 && runs.unused[best] - 1 > 1) {
+            columnBestInterval.size = runs.unused[best] - 1;
+            columnBestInterval.start = runs.first[best];
+            columnBestInterval.end = runs.last[best];
+            columnBestInterval.dominantClass = attributeColumns.classNum(attributeColumns[column][runs.first[best]]);
+            columnBestInterval.attribute = column;
+        }
+
+        state.columnBest[column] = columnBestInterval;
+
+        // no intervals left to find in this attribute, even if it's not the best. never look at it again.
+        if (columnBestInterval.size < 2) {
+            state.doneColumns[column] = 1;
+        }
+    } // end of one column
+}
+
+// EXACTLY THE SAME AS THE INTERVAL HYPER ALGORITHM, BUT IT USES A MANAGER WORKER SETUP INSTEAD OF LAUNCHING THREADS AND KILLING AND LAUNCHING AGAIN
+// takes in the training data which is broken up so that each value of each point is broken up into DataATTR's. finds longest interval of an attribute which is all one class.
+// then makes HBs out of all those points we found which belong to an interval.
+// every round is: everybody updates their columns, barrier, supervisor picks the best interval and makes the block, barrier. one block per round,
+// so the rounds are cheap on purpose. the threads stay up the whole time and only sleep if a round takes a while.
+void IntervalHyperBlock::intervalHyperSupervisor(vector<vector<vector<float>>> &realData, AttributeColumns &dataByAttribute, vector<HyperBlock> &hyperBlocks, int COMMAND_LINE_ARGS_CLASS) {
+
+    // sort the columns again. they come out of separateByAttribute sorted already, but the second sort moves tied values around,
+    // and the blocks have always been made from the ties in this order.
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < (int)dataByAttribute.size(); i++) {
+        sortColumn(dataByAttribute[i]);
+    }
+
+    const int numColumns = dataByAttribute.size();
+
+    // get our number of workers, the supervisor counts as one of them.
+    int numWorkers = max(1, min((int)thread::hardware_concurrency(), numColumns));
+
+    const int numPoints = dataByAttribute.numPoints();
+
+    RoundState state(numWorkers, numColumns, numPoints);
+    state.liveColumns.resize(numColumns);
+    iota(state.liveColumns.begin(), state.liveColumns.end(), 0);
+    state.dealColumns();
+
+    vector<thread> workers;
+    workers.reserve(numWorkers - 1);
+    for (int i = 1; i < numWorkers; i++) {
+        workers.emplace_back([&, i]() {
+            while (true) {
+                // wait for the round to start. the supervisor sets stop before letting us go if there's nothing left.
+                state.barrier.arriveAndWait();
+                if (state.stop)
+                    return;
+                intervalHyperWorker(dataByAttribute, state, i, COMMAND_LINE_ARGS_CLASS);
+                state.barrier.arriveAndWait();
+            }
+        });
+    }
+
+    while (true) {
+
+        // start the round, do our share of columns, and wait for everyone else to finish theirs.
+        state.barrier.arriveAndWait();
+        intervalHyperWorker(dataByAttribute, state, 0, COMMAND_LINE_ARGS_CLASS);
+        state.barrier.arriveAndWait();
+
+        // find the best interval. ties go to the lowest column so it comes out the same no matter how many threads we have.
+        Interval bestInterval(-1, -1, -1, -1, -1);
+        for (int column : state.liveColumns) {
+            const Interval &interval = state.columnBest[column];
+            if (interval.size > bestInterval.size && interval.size > 1) {
+                bestInterval = interval;
+            }
+        }
+
+        // if we didn't have a best interval of more than 1 point. we are done, let the workers go home.
+        if (bestInterval.size <= 1) {
+            state.stop = true;
+            state.barrier.arriveAndWait();
+            break;
+        }
+
+        const vector<DataATTR> &bestColumn = dataByAttribute[bestInterval.attribute];
+
+        // make our list of points which are in this best interval, and mark them all in the bitmap. the workers update their own columns next round.
+        state.newlyUsed.clear();
+        vector<vector<float>> pointsInThisBlock;
+        pointsInThisBlock.reserve(bestInterval.size + 1);  // reserve capacity to avoid extra copies
+        for (int i = bestInterval.start; i <= bestInterval.end; i++) {
+
+            // From the best attribute column, grab the identification for the point.
+            const DataATTR &thisPoint = bestColumn[i];
+
+            // don't use the same point multiple times.
+            if (state.isUsed(thisPoint)) {
+                continue;
+            }
+
+            state.markUsed(thisPoint);
+
+            // Get the actual point from the real data and add it.
+            pointsInThisBlock.push_back(realData[dataByAttribute.classNum(thisPoint)][dataByAttribute.classIndex(thisPoint)]);
+        }
+
+        // Compute bounds for each attribute.
+        vector<vector<float>> maxes(numColumns, vector<float>(1, -numeric_limits<float>::infinity()));
+        vector<vector<float>> mins(numColumns, vector<float>(1, numeric_limits<float>::infinity()));
+        for (auto & point : pointsInThisBlock) {
+            for (int att = 0; att < numColumns; att++) {
+                maxes[att][0] = max(point[att], maxes[att][0]);
+                mins[att][0] = min(point[att], mins[att][0]);
+            }
+        }
+
+        // make a block and throw it into the hyperblocks vector
+        HyperBlock h(maxes, mins, bestInterval.dominantClass);
+        hyperBlocks.push_back(h);
+
+        // drop the columns which ran dry, and deal the rest back out for the next round.
+        state.liveColumns.erase(remove_if(state.liveColumns.begin(), state.liveColumns.end(), [&](int column) { return state.doneColumns[column]; }), state.liveColumns.end());
+        state.dealColumns();
+    }
+
+    for (auto &worker : workers) {
+        if (worker.joinable())
+            worker.join();
+    }
+
+    // at the end of that loop, we have a bunch of points which we have not put into blocks. We now make all those guys into their own one point blocks.
+    // this is easy, you just find the guys who aren't used yet, and make them their own block to live in.
+    // we only have to use one column, since all the data points are in each column. the bitmap is the up to date one, dataByAttribute.used is never set.
+    vector<pair<int, int>> notUsedPoints;
+    for (auto &dataAtt : dataByAttribute[0]) {
+        if (!state.isUsed(dataAtt)) {
+            notUsedPoints.push_back({dataByAttribute.classNum(dataAtt), dataByAttribute.classIndex(dataAtt)});
+        }
+    }
+
+    // loop through all the points, and find the guys who are not used, and make blocks out of them.
+    for (auto &point : notUsedPoints) {
+        int classNum = point.first;
+
+        // if we are just doign one class, and that class is not the class of this dataPoint, then we skip it. don't make blocks unnecessarily
+        if (COMMAND_LINE_ARGS_CLASS != -1 && COMMAND_LINE_ARGS_CLASS != classNum)
+            continue;
+
+        int classIndex = point.second;
+
+        // copy this point into it's own HB.
+        vector<float> thisPoint = realData[classNum][classIndex];
+
+        vector<vector<float>> mins(dataByAttribute.size());
+        vector<vector<float>> maxes(dataByAttribute.size());
+        // copy the point in as both min and max
+        for (int att = 0; att < dataByAttribute.size(); att++) {
+            mins[att].push_back(thisPoint[att]);
+            maxes[att].push_back(thisPoint[att]);
+        }
+        // make a block and throw it into the hyperblocks vector
+        HyperBlock h(maxes, mins, classNum);
+        hyperBlocks.push_back(h);
+    }
+}
+
+// use with the regular interval hyper below. Used with openMP or futures to launch a thread to get longest attribute, but it is inefficient because you make a kill so many threads.
+Interval IntervalHyperBlock::longestInterval(AttributeColumns &columns, const ColumnTies &ties, int attribute)
+{
+    const vector<DataATTR> &dataByAttribute = columns[attribute];
+    cout << "Attribute ran on: " << attribute << endl;
+    Interval bestInterval(-1, -1, -1, attribute, -1);
+    int n = static_cast<int>(dataByAttribute.size());
+    int currentStart = 0;
+
+    while (currentStart < n) {
+        // Skip "used" items to find a valid start:
+        while (currentStart < n && columns.isUsed(dataByAttribute[currentStart])) {
+            currentStart++;
+        }
+
+        if (currentStart >= n) {
+            break; // all used or out of range
+        }
+
+        //------------------------------------------------------------------
+        // BACKWARD CHECK for mismatch among same-value items
+        //------------------------------------------------------------------
+        int startClass = columns.classNum(dataByAttribute[currentStart]);
+
+        // if our back check failed, that means there is a matching value behind us, from the wrong class.
+        // this means we have to just move on as an interval of ONE no matter what. we aren't using intervals of one, so just continue
+        if (!checkValidStart(ties, currentStart)) {
+            // move one and carry on
+            currentStart++;
+            continue;
+        }
+
+        //------------------------------------------------------------------
+        // 3) FORWARD EXTENSION to find the longest run
+        //------------------------------------------------------------------
+        int currentEnd = currentStart; // we'll move this as far as we can
+        while (currentEnd < n) {
+            if (!columns.inClass(dataByAttribute[currentEnd], startClass)) {
+                break;
+            }
+            currentEnd++;
+        }
+
+        int length = currentEnd - currentStart;
+        if (length > bestInterval.size && length > 1) {
+            bestInterval.size = length;
+            bestInterval.start = currentStart;
+            bestInterval.end = currentEnd - 1;
+            bestInterval.dominantClass = startClass;
+        }
+
+        //------------------------------------------------------------------
+        // Move on to the next interval start
+        //------------------------------------------------------------------
+        currentStart = currentEnd;
+    }
+
+    // now, one final check. we are going to simply trim off values at the end, if they are matching with exact same value as a wrong class point
+    int finalEnd = bestInterval.end;
+
+    // if we won't go out of bounds by checking the next one
+    if (finalEnd < n - 1) {
+        // get our next value
+        float neighborVal = dataByAttribute[bestInterval.end + 1].value;
+
+        // while there is a match between the next value and where we are trying to end, we have to trim off our end guy.
+        // this prevents us from making an interval which includes a value which would be shared between our class and another class.
+        while (finalEnd > bestInterval.start && closeEnough(neighborVal, dataByAttribute[finalEnd].value)) {
+            finalEnd--;
+        }
+        bestInterval.end = finalEnd;
+    }
+    return bestInterval;
+}
+
+// takes in a vector of DataATTR's per attribute. which are simply our data, chopped up by attribute. Finds the longest interval of all one class across all attributes iteratively.
+// populates the list of hyperblocks, and we then send those blocks to the merger_cuda to get smashed together as much as possible.
+void IntervalHyperBlock::intervalHyper(vector<vector<vector<float>>> &realData, AttributeColumns &remainingData, vector<HyperBlock> &hyperBlocks) {
+    // sort the columns again, same as intervalHyperSupervisor. which entries are valid starts never changes after this, so the tie groups only get worked out once.
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < (int)remainingData.size(); i++) {
+        sortColumn(remainingData[i]);
+    }
+    vector<ColumnTies> columnTies(remainingData.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < remainingData.size(); i++) {
+        columnTies[i].build(remainingData, i);
+    }
+    vector<bool> doneFlags(remainingData.size(), false);
+
+    while (true) {
+
+        // Launch our intervals asynchronously; get the intervals back and pick the biggest.
+        vector<future<Interval>> intervals;
+        Interval best(-1, -1, -1, -1, -1);
+
+        // Search each attribute
+        for (int i = 0; i < remainingData.size(); i++) {
+            // if we are done with the column, just skip.
+            if (doneFlags[i] == true)
+                continue;
+
+            intervals.emplace_back(async(launch::async, longestInterval, ref(remainingData), cref(columnTies[i]), i));
+        }
+
+        // Wait for results then find largest interval
+        for (int i = 0; i < intervals.size(); i++) {
+
+            // if we already did this column completely skip
+            if (doneFlags[i] == true)
+                continue;
+
+            // else get our result from this column
+            Interval intr = intervals[i].get();
+            // if it returned -1, that means the attribute is done and we don't need to keep checking it. helpful for high attribute datasets.
+            if (intr.size == -1) {
+                doneFlags[i] = true;
+            }
+            else {
+                // we had an interval, check if it's better than current best.
+                if (intr.size >= 1 && intr.size > best.size) {
+                    best = intr;  // copy entire interval
+                }
+            }
+        }
+
+        // Build a list of removed points based on the best interval.
+        // (We assume that best.start and best.end are valid indices in remainingData[attr].)
+        vector<int> usedIDs;
+
+        // if we had a valid interval, we have to do all this business
+        // if there was not we are obviously just done.
+
+        if (best.size > 1) {
+            // DONE BY SUPERVISOR AND true BY EVERYONE
+            for (int i = best.start; i <= best.end; i++) {
+                DataATTR d = remainingData[best.attribute][i];
+                if (!remainingData.isUsed(d))
+                    usedIDs.push_back(d.id);
+            }
+
+            // Build the block of points from the real data.
+            // DONE BY SUPERVISOR
+            vector<vector<float>> pointsInThisBlock;
+            pointsInThisBlock.reserve(best.size);  // reserve capacity to avoid extra copies
+            for (int i = best.start; i <= best.end; i++) {
+
+                // From the best attribute column, grab the identification for the point.
+                DataATTR thisPoint = remainingData[best.attribute][i];
+
+                if (remainingData.isUsed(thisPoint)) {
+                    continue;
+                }
+
+                int classNum = remainingData.classNum(thisPoint);
+                int classIndex = remainingData.classIndex(thisPoint);
+
+                // Get the actual point from the real data and add it.
+                pointsInThisBlock.push_back(realData[classNum][classIndex]);
+            }
+
+            // Compute bounds for each attribute.
+            vector<vector<float>> maxes(remainingData.size(), vector<float>(1, -numeric_limits<float>::infinity()));
+            vector<vector<float>> mins(remainingData.size(), vector<float>(1, numeric_limits<float>::infinity()));
+
+            for (auto & point : pointsInThisBlock) {
+                for (int att = 0; att < remainingData.size(); att++) {
+                    maxes[att][0] = max(point[att], maxes[att][0]);
+                    mins[att][0] = min(point[att], mins[att][0]);
+                }
+            }
+
+            // make a block and throw it into the hyperblocks vector
+            HyperBlock h(maxes, mins, best.dominantClass);
+            hyperBlocks.push_back(h);
+
+            // the used flags are by point, not by column entry, so marking them once covers every column.
+            for (int id : usedIDs) {
+                remainingData.used[id] = true;
+            }
+        }
+
+        // once all the attributes returned us no intervals or just intervals of one, we break.
+        else
+            break;
+    }
+
+    // at the end of that loop, we have a bunch of points which we have not put into blocks. We now make all those guys into their own one point blocks.
+    // this is easy, you just find the guys who aren't used yet, and make them their own block to live in.
+    // we only have to use one column, since all the data points are in each column.
+    vector<pair<int, int>> notUsedPoints;
+    for (auto &dataAtt : remainingData[0]) {
+        if (!remainingData.isUsed(dataAtt)) {
+            notUsedPoints.push_back({remainingData.classNum(dataAtt), remainingData.classIndex(dataAtt)});
+        }
+    }
+
+    // loop through each class and all their points, and find the guys who are not used, and make blocks out of them.
+    for (auto &point : notUsedPoints) {
+        int classNum = point.first;
+        int classIndex = point.second;
+
+        // copy this point into it's own HB.
+        vector<float> thisPoint = realData[classNum][classIndex];
+
+        vector<vector<float>> mins(remainingData.size());
+        vector<vector<float>> maxes(remainingData.size());
+        // copy the point in as both min and max
+        for (int att = 0; att < remainingData.size(); att++) {
+            mins[att].push_back(thisPoint[att]);
+            maxes[att].push_back(thisPoint[att]);
+        }
+        // make a block and throw it into the hyperblocks vector
+        HyperBlock h(maxes, mins, classNum);
+        hyperBlocks.push_back(h);
+    }
+}
+
+// the class / index side arrays for points numbered class by class, classOffsets has to be filled in already.
+static void numberPoints(AttributeColumns &attributes) {
+    const int numPoints = attributes.numPoints();
+    attributes.classOf.resize(numPoints);
+    attributes.indexInClass.resize(numPoints);
+    attributes.used.assign(numPoints, 0);
+    for (int i = 0; i + 1 < attributes.classOffsets.size(); i++) {
+        for (int id = attributes.classOffsets[i]; id < attributes.classOffsets[i + 1]; id++) {
+            attributes.classOf[id] = i;
+            attributes.indexInClass[id] = id - attributes.classOffsets[i];
+        }
+    }
+}
+
+/**
+ * Seperates data into seperate vecs by attribute. Each column holds every point, sorted by value (see sortColumn for the ties).
+ * The ids go class by class, so class c is [classOffsets[c], classOffsets[c + 1]). The columns are sorted in parallel.
+ */
+AttributeColumns IntervalHyperBlock::separateByAttribute(const vector<vector<vector<float>>>& data, int FIELD_LENGTH){
+    AttributeColumns attributes;
+
+    // give every point its global id, and remember where it came from.
+    attributes.classOffsets.assign(data.size() + 1, 0);
+    for (int i = 0; i < data.size(); i++) {
+        attributes.classOffsets[i + 1] = attributes.classOffsets[i] + data[i].size();
+    }
+    numberPoints(attributes);
+    const int numPoints = attributes.numPoints();
+
+    // Go through the attribute columns, every one is independent.
+    attributes.columns.resize(FIELD_LENGTH);
+    #pragma omp parallel for schedule(dynamic)
+    for(int k = 0; k < FIELD_LENGTH; k++){
+        vector<DataATTR> &tmpField = attributes.columns[k];
+        tmpField.resize(numPoints);
+
+        // Go through the classes, then the points
+        for(int i = 0; i < data.size(); i++){
+            for(int j = 0; j < data[i].size(); j++){
+                tmpField[attributes.classOffsets[i] + j] = DataATTR(data[i][j][k], attributes.classOffsets[i] + j);
+            }
+        }
+
+        // Sort data by value
+        sortColumn(tmpField);
+    }
+
+    return attributes;
+}
+
+// same thing, from the row major dataset and class borders flattenDataset makes. row p is global id p.
+AttributeColumns IntervalHyperBlock::separateByAttribute(const float *dataset, int numPoints, const int *classBorder, int numClasses, int FIELD_LENGTH) {
+    AttributeColumns attributes;
+    attributes.classOffsets.assign(classBorder, classBorder + numClasses + 1);
+    numberPoints(attributes);
+
+    attributes.columns.resize(FIELD_LENGTH);
+    #pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < FIELD_LENGTH; k++) {
+        vector<DataATTR> &tmpField = attributes.columns[k];
+        tmpField.resize(numPoints);
+        for (int p = 0; p < numPoints; p++) {
+            tmpField[p] = DataATTR(dataset[(size_t)p * FIELD_LENGTH + k], p);
+        }
+        sortColumn(tmpField);
+    }
+
+    return attributes;
+}
+
+/***
+ * This will sort the array based on the "best" columns values
+ *
+ * The columns themselves aren't moving, we are moving the points
+ * based on the one columns values;
+ */
+void IntervalHyperBlock::sortByColumn(vector<vector<float>>& classData, int colIndex) {
+    sort(classData.begin(), classData.end(), [colIndex](const vector<float>& a, const vector<float>& b) {
+        return a[colIndex] < b[colIndex];
+    });
+}
+
+/**
+ * This function takes in the dataset and other supporting info used for optimizing the block creation
+ * and then generates HBs.
+ *
+ * It first calls the IntervalHyper algorithm. This will find the pure intervals of a class on each attribute and
+ * make simple hbs out of them.
+ *
+ * After this the simple HBs are passed to the merger cuda algorithm to be merged together.
+ *
+ * This won't generate all combinations of all points, which means it may be missing some patterns, however,
+ * that method is ultra computationally expensive so this approach was taken. If one wanted to, they could send in all the points
+ * in the dataset to the merger cuda algorithm without running the interval algorithm first. This would just treat each point as a single point
+ * HB and merge like normal.
+ *
+ * More info, once again in: "Fully Explainable Classification Models Using Hyperblocks", 2025. Ryan Gallagher, Austin Snyder, Boris Kovalerchuk
+ *
+ * @param data The training dataset to build hyperblocks from
+ * @param hyperBlocks The empty hyperblocks vector to be populated with HBs that are generated.
+ * @param bestAttributes
+ * @param FIELD_LENGTH The number of features in this dataset.
+ * @param COMMAND_LINE_ARGS_CLASS Command line argument taken in, allows to run on a single class at a time. For example, if you run on the 4090s in the SAMU140 lab.
+ *                                this would allow you to split the classes between each machine. (MPI might be possible for this instead of manually running
+ *                                , but we never got around to getting access)
+ */
+void IntervalHyperBlock::generateHBs(vector<vector<vector<float>>>& data, vector<HyperBlock>& hyperBlocks, vector<int> &bestAttributes, int FIELD_LENGTH, int COMMAND_LINE_ARGS_CLASS){
+
+    // Get data to create hyperblocks
+    AttributeColumns dataByAttribute = separateByAttribute(data, FIELD_LENGTH);
+
+    cout << "STARTING INTERVAL HYPER" << endl;
+    // make our interval based blocks
+
+    // these two functions use almost identical logic, except that one uses a supervisor thread and workers, instead of
+    // constantly launching and killing threads each iteration. Supervisor version works better on any machine except cwu cluster.
+    // intervalHyper(data, dataByAttribute, hyperBlocks);
+    intervalHyperSupervisor(data, dataByAttribute, hyperBlocks, COMMAND_LINE_ARGS_CLASS);
+
+    // makes blocks by finding pure area surrounding a point of correct class, slightly different than usual way where we take the longest interval, and use those points to find our bounds in each attribute.
+    // can get a slightly better accuracy, but generates more blocks
+    // pureBlockIntervalHyper(dataByAttribute, data, hyperBlocks, COMMAND_LINE_ARGS_CLASS);
+    cout << "Num blocks after interval: " << hyperBlocks.size() << endl;
+    cout << "STARTING MERGING" << endl;
+    try{
+        // runs on the GPU if we have one, or the CPU if we don't. (see ComputeBackend)
+        merger_cuda(data, hyperBlocks, COMMAND_LINE_ARGS_CLASS);
+
+        // not in cuda is a more efficient algorithm, but is slower because its not on GPU.
+        // if we run into more time challenges, our lives may be simpler if we revisit the merger cuda function and make it use this kind of set based logic instead.
+        // dataByAttribute = separateByAttribute(data, FIELD_LENGTH);
+        // mergerNotInCuda(data, hyperBlocks, dataByAttribute);
+
+        // Assign the block an ID so we can keep track of it across simplifications and removals!
+        for(int i = 0; i < hyperBlocks.size(); i++) {
+            hyperBlocks[i].blockId = i;
+        }
+
+    } catch (exception e){
+        cout << "Error in generateHBs: merger_cuda" << endl;
+        cout << e.what() << endl;
+    }
+}
+
+// orders points along a Morton (z-order) curve so points next to each other in the buffer are also close in space.
+// each attribute gets quantized over its own range, then the bits are interleaved. 64 bits doesn't go far with lots of attributes,
+// so we only use the first 64 attributes, with at least 1 bit each. only the grouping matters here, it doesn't change any results.
+static vector<int> mortonOrder(const vector<const vector<float>*> &points, int FIELD_LENGTH) {
+    const int numPoints = points.size();
+    const int dims = min(FIELD_LENGTH, 64);
+    const int bitsPerDim = max(1, 64 / max(dims, 1));
+
+    vector<float> lows(dims, numeric_limits<float>::infinity());
+    vector<float> highs(dims, -numeric_limits<float>::infinity());
+    for (const vector<float> *point : points) {
+        for (int a = 0; a < dims; a++) {
+            lows[a] = min(lows[a], (*point)[a]);
+            highs[a] = max(highs[a], (*point)[a]);
+        }
+    }
+
+    const uint64_t cells = (1ULL << bitsPerDim) - 1;
+    vector<uint64_t> codes(numPoints, 0);
+    #pragma omp taskloop grainsize(1024) default(shared)
+    for (int p = 0; p < numPoints; p++) {
+        vector<uint64_t> q(dims);
+        for (int a = 0; a < dims; a++) {
+            float range = highs[a] - lows[a];
+            float t = range > 0 ? ((*points[p])[a] - lows[a]) / range : 0.0f;
+            q[a] = min((uint64_t)(t * cells + 0.5f), cells);
+        }
+        uint64_t code = 0;
+        for (int bit = bitsPerDim - 1; bit >= 0; bit--) {
+            for (int a = 0; a < dims; a++) {
+                code = (code << 1) | ((q[a] >> bit) & 1ULL);
+            }
+        }
+        codes[p] = code;
+    }
+
+    vector<int> order(numPoints);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return codes[a] < codes[b]; });
+    return order;
+}
+
+// builds the padded block bounds and the SoA float4 opposing points for each class, then hands them to the compute backend to do the actual merging.
+// the name is left over from when this only ran on the GPU, it runs on whatever ComputeBackend::get() picked now.
+void IntervalHyperBlock::merger_cuda(const vector<vector<vector<float>>>& allData, vector<HyperBlock>& hyperBlocks, int COMMAND_LINE_ARGS_CLASS) {
+
+    int NUM_CLASSES = allData.size();
+    int FIELD_LENGTH = allData[0][0].size();
+
+    cout << "Num classes " << NUM_CLASSES << endl;
+
+    ComputeBackend &backend = ComputeBackend::get();
+
+    int PADDED_LENGTH = ((FIELD_LENGTH + 3) / 4) * 4;
+    int numAttributesAsFours = PADDED_LENGTH / 4;
+
+    int temp = 0;
+    int goToClass = NUM_CLASSES;
+    if (COMMAND_LINE_ARGS_CLASS != -1){
+         temp = COMMAND_LINE_ARGS_CLASS;
+         goToClass = COMMAND_LINE_ARGS_CLASS + 1;
+    }
+
+    vector<vector<HyperBlock>> inputBlocks(NUM_CLASSES);
+    vector<vector<HyperBlock>> resultingBlocks(NUM_CLASSES);
+    for (HyperBlock& hyperBlock : hyperBlocks) {
+        // store this block in the slot which corresponds to it's class.
+        inputBlocks[hyperBlock.classNum].push_back(hyperBlock);
+    }
+
+    // every class only merges against the other classes' points, which nobody writes to, so the classes are independent.
+    // each one is a task, whichever thread is free picks up the next class. the backend's own work goes into the same pool
+    // on the CPU, and on the GPU each class gets its own stream.
+    #pragma omp parallel
+    #pragma omp single
+    for (int classN = temp; classN < goToClass; classN++) {
+        #pragma omp task firstprivate(classN) shared(inputBlocks, resultingBlocks, allData, backend)
+        {
+            int numBlocks = inputBlocks[classN].size();
+
+            // Allocate host memory
+            vector<float> hyperBlockMinsC(numBlocks * PADDED_LENGTH);
+            vector<float> hyperBlockMaxesC(numBlocks * PADDED_LENGTH);
+            vector<int> deleteFlagsC(numBlocks, 0);
+
+            // slot j of every flattened block and point holds attribute attrSlots[j]. the attributes which throw out the most
+            // opposing points come first, so the point scan (and the tile check) usually quits in the first chunk of 4.
+            // everything is permuted the same way so the merges come out the same, we just put it back in order after.
+            vector<int> attrSlots = HyperBlock::rejectionOrder(inputBlocks[classN], allData, classN);
+
+            // Fill hyperblock array
+            for (int i = 0; i < numBlocks; i++) {
+                HyperBlock &h = inputBlocks[classN][i];
+                for (int j = 0; j < FIELD_LENGTH; j++) {
+                    hyperBlockMinsC[i * PADDED_LENGTH + j] = h.minimums[attrSlots[j]][0];
+                    hyperBlockMaxesC[i * PADDED_LENGTH + j] = h.maximums[attrSlots[j]][0];
+                }
+                for (int j = FIELD_LENGTH; j < PADDED_LENGTH; j++) {
+                    hyperBlockMinsC[i * PADDED_LENGTH + j] = -numeric_limits<float>::infinity();
+                    hyperBlockMaxesC[i * PADDED_LENGTH + j] = numeric_limits<float>::infinity();
+                }
+            }
+
+            vector<const vector<float>*> otherPoints;
+            for (int currentClass = 0; currentClass < allData.size(); currentClass++) {
+                if (currentClass == classN) continue;
+                for (const auto& point : allData[currentClass]) {
+                    otherPoints.push_back(&point);
+                }
+            }
+            int numOtherPoints = otherPoints.size();
+
+            // put the other class points in Morton order, so each tile of OPPOSING_TILE_SIZE points is a tight little clump in space.
+            vector<int> order = mortonOrder(otherPoints, FIELD_LENGTH);
+
+            // build the SoA float4 array of other class points. chunk i of point p lives at [(i * numOtherPoints + p) * 4]
+            // this way threads working on adjacent points read adjacent memory. padded attributes are -inf so they're always "inside".
+            // next to it goes the bounding box of each tile, laid out like the block bounds. a merge skips any tile whose box misses the combined block.
+            int numTiles = (numOtherPoints + OPPOSING_TILE_SIZE - 1) / OPPOSING_TILE_SIZE;
+            vector<float> hostOpp4((size_t)numAttributesAsFours * numOtherPoints * 4);
+            vector<float> tileMins((size_t)numTiles * PADDED_LENGTH, numeric_limits<float>::infinity());
+            vector<float> tileMaxes((size_t)numTiles * PADDED_LENGTH, -numeric_limits<float>::infinity());
+            for (int p = 0; p < numOtherPoints; p++) {
+                const vector<float> &point = *otherPoints[order[p]];
+                float *tileMin = &tileMins[(size_t)(p / OPPOSING_TILE_SIZE) * PADDED_LENGTH];
+                float *tileMax = &tileMaxes[(size_t)(p / OPPOSING_TILE_SIZE) * PADDED_LENGTH];
+                for (int attr = 0; attr < PADDED_LENGTH; attr++) {
+                    float v = attr < FIELD_LENGTH ? point[attrSlots[attr]] : -numeric_limits<float>::infinity();
+                    hostOpp4[((size_t)(attr / 4) * numOtherPoints + p) * 4 + (attr % 4)] = v;
+                    tileMin[attr] = min(tileMin[attr], v);
+                    tileMax[attr] = max(tileMax[attr], v);
+                }
+            }
+
+            printf("Merging class: %d\n", classN);
+
+            backend.mergeBlocks(hyperBlockMinsC.data(), hyperBlockMaxesC.data(), numBlocks, PADDED_LENGTH, hostOpp4.data(), numOtherPoints, tileMins.data(), tileMaxes.data(), deleteFlagsC.data());
+
+            // Process results
+            for (int i = 0; i < numBlocks; i++) {
+
+                if (deleteFlagsC[i] == -1) continue;  // -1 is a seed block which was merged to. so it doesn't need to be copied back.
+
+                vector<vector<float>> blockMins(FIELD_LENGTH);
+                vector<vector<float>> blockMaxes(FIELD_LENGTH);
+                for (int j = 0; j < FIELD_LENGTH; j++) {
+                    blockMins[attrSlots[j]].push_back(hyperBlockMinsC[i * PADDED_LENGTH + j]);
+                    blockMaxes[attrSlots[j]].push_back(hyperBlockMaxesC[i * PADDED_LENGTH + j]);
+                }
+                HyperBlock hb(blockMaxes, blockMins, classN);
+                resultingBlocks[classN].emplace_back(hb);
+            }
+        }
+    }
+
+    hyperBlocks.clear();
+    for(const vector<HyperBlock>& classBlocks : resultingBlocks) {
+      hyperBlocks.insert(hyperBlocks.end(), classBlocks.begin(), classBlocks.end());
+    }
+
+    // Assign them their size.
+    HyperBlock::find_avg_and_size_all(hyperBlocks, allData);
+}
+
+static inline int popcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    while (word) {
+        word &= word - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+// helper function. takes in a block, and the DataByAttribute columns. What we do is just check our interval of each attribute.
+// we make a list of wrong class points in each column. if any wrong class point is inside of all the lists, (inside our bounds for all attributes) we fail.
+// if every wrong class point is missing from at least one list, we pass.
+//
+// the lists are bitmaps over the global point ids (DataATTR::id), one bit per training point.
+// we start from the narrowest column, then AND in the other columns one at a time, and quit as soon as no bits survive.
+// the bitmaps are thread_local scratch, so after the first call on a thread this doesn't allocate anything.
+bool IntervalHyperBlock::checkMergable(AttributeColumns &dataByAttribute, HyperBlock &h, const vector<int> &classOffsets) {
+
+    int FIELD_LENGTH = dataByAttribute.size();
+    const int numPoints = classOffsets.back();
+    const int numWords = (numPoints + 63) / 64;
+
+    static thread_local vector<uint64_t> survivors;
+    static thread_local vector<uint64_t> columnBits;
+    static thread_local vector<int> columnOrder;
+    if (survivors.size() < numWords) {
+        survivors.assign(numWords, 0);
+        columnBits.assign(numWords, 0);
+    }
+    columnOrder.resize(FIELD_LENGTH);
+
+    // an empty window in any column means no points can be inside the block at all.
+    for (int column = 0; column < FIELD_LENGTH; column++) {
+        const pair<int, int> &window = h.topBottomPairs[column];
+        if (window.first < 0 || window.second < window.first)
+            return true;
+        columnOrder[column] = column;
+    }
+
+    // narrowest windows first, they give the smallest starting set and the quickest early exits.
+    sort(columnOrder.begin(), columnOrder.end(), [&](int a, int b) {
+        return h.topBottomPairs[a].second - h.topBottomPairs[a].first < h.topBottomPairs[b].second - h.topBottomPairs[b].first;
+    });
+
+    // seed the survivors with the wrong class points of the narrowest column. we track which words we touched so we only ever AND / clear those.
+    int firstColumn = columnOrder[0];
+    int loWord = numWords;
+    int hiWord = -1;
+    int survivorCount = 0;
+    for (int start = h.topBottomPairs[firstColumn].first; start <= h.topBottomPairs[firstColumn].second; start++) {
+        const DataATTR &d = dataByAttribute[firstColumn][start];
+        if (dataByAttribute.inClass(d, h.classNum)) continue;
+
+        int id = d.id;
+        int word = id >> 6;
+        survivors[word] |= (uint64_t)1 << (id & 63);
+        loWord = min(loWord, word);
+        hiWord = max(hiWord, word);
+        survivorCount++;
+    }
+
+    for (int c = 1; c < FIELD_LENGTH && survivorCount > 0; c++) {
+        int column = columnOrder[c];
+
+        // only points which are still surviving matter, so anything outside the survivor word range gets skipped.
+        for (int start = h.topBottomPairs[column].first; start <= h.topBottomPairs[column].second; start++) {
+            const DataATTR &d = dataByAttribute[column][start];
+            if (dataByAttribute.inClass(d, h.classNum)) continue;
+
+            int id = d.id;
+            int word = id >> 6;
+            if (word < loWord || word > hiWord) continue;
+            columnBits[word] |= (uint64_t)1 << (id & 63);
+        }
+
+        // AND word by word, clearing the column bits as we go so they're ready for the next column.
+        survivorCount = 0;
+        int newLo = numWords;
+        int newHi = -1;
+        for (int w = loWord; w <= hiWord; w++) {
+            uint64_t word = survivors[w] & columnBits[w];
+            survivors[w] = word;
+            columnBits[w] = 0;
+            if (word) {
+                survivorCount += popcount64(word);
+                newLo = min(newLo, w);
+                newHi = max(newHi, w);
+            }
+        }
+        loWord = newLo;
+        hiWord = newHi;
+    }
+
+    // leave the scratch clean for the next call.
+    for (int w = loWord; w <= hiWord; w++) {
+        survivors[w] = 0;
+    }
+
+    // if anyone survived every column, there's a wrong class point inside our bounds.
+    return survivorCount == 0;
+}
+
+// is point id inside every one of the windows? columnRanks[a * numPoints + id] is where point id sits in sorted column a.
+static inline bool insideWindows(int id, const vector<pair<int, int>> &windows, int numPoints, const vector<int> &columnRanks) {
+    for (int a = 0; a < windows.size(); a++) {
+        const int rank = columnRanks[(size_t)a * numPoints + id];
+        if (rank < windows[a].first || rank > windows[a].second)
+            return false;
+    }
+    return true;
+}
+
+// the watchlist for a block: every wrong class point which is inside all of the block's windows.
+// we walk the narrowest window and check each wrong class point against the rest with the ranks. for a pure block this comes back empty.
+static vector<int> buildWatchlist(const AttributeColumns &dataByAttribute, const vector<pair<int, int>> &windows, int classNum, const vector<int> &classOffsets, const vector<int> &columnRanks) {
+    const int FIELD_LENGTH = dataByAttribute.size();
+    const int numPoints = classOffsets.back();
+    vector<int> watchlist;
+
+    int narrowest = 0;
+    for (int a = 0; a < FIELD_LENGTH; a++) {
+        if (windows[a].first < 0 || windows[a].second < windows[a].first)
+            return watchlist;
+        if (windows[a].second - windows[a].first < windows[narrowest].second - windows[narrowest].first)
+            narrowest = a;
+    }
+
+    for (int i = windows[narrowest].first; i <= windows[narrowest].second; i++) {
+        const DataATTR &d = dataByAttribute[narrowest][i];
+        if (dataByAttribute.inClass(d, classNum)) continue;
+
+        const int id = d.id;
+        if (insideWindows(id, windows, numPoints, columnRanks))
+            watchlist.push_back(id);
+    }
+    return watchlist;
+}
+
+// incremental version of checkMergable. the candidate's own windows were already checked (that's its watchlist), so the only new suspects
+// are the wrong class points in the slices each column got widened by, [newLow, oldLow) and (oldHigh, newHigh]. any of those which is inside
+// every combined window fails the merge. returns that point's id, or -1 if the merge is fine.
+static int findWidenedSliceViolator(const AttributeColumns &dataByAttribute, const vector<pair<int, int>> &oldWindows, const vector<pair<int, int>> &newWindows, int classNum, const vector<int> &classOffsets, const vector<int> &columnRanks) {
+    const int FIELD_LENGTH = dataByAttribute.size();
+    const int numPoints = classOffsets.back();
+
+    for (int a = 0; a < FIELD_LENGTH; a++) {
+        if (newWindows[a].first < 0 || newWindows[a].second < newWindows[a].first)
+            return -1;
+    }
+
+    for (int a = 0; a < FIELD_LENGTH; a++) {
+        const int newLow = newWindows[a].first;
+        const int newHigh = newWindows[a].second;
+        int oldLow = oldWindows[a].first;
+        int oldHigh = oldWindows[a].second;
+
+        // no old window means the whole thing is new.
+        if (oldLow < 0 || oldHigh < oldLow) {
+            oldLow = newHigh + 1;
+            oldHigh = newHigh;
+        }
+
+        for (int i = newLow; i < oldLow; i++) {
+            const DataATTR &d = dataByAttribute[a][i];
+            const int id = d.id;
+            if (!dataByAttribute.inClass(d, classNum) && insideWindows(id, newWindows, numPoints, columnRanks))
+                return id;
+        }
+        for (int i = oldHigh + 1; i <= newHigh; i++) {
+            const DataATTR &d = dataByAttribute[a][i];
+            const int id = d.id;
+            if (!dataByAttribute.inClass(d, classNum) && insideWindows(id, newWindows, numPoints, columnRanks))
+                return id;
+        }
+    }
+    return -1;
+}
+
+// the last few wrong class points which stopped a block from merging. the bounds only grow, so they usually stop it again.
+struct WitnessRing {
+    int points[WITNESS_RING_SIZE];
+    int head = 0;
+    WitnessRing() { fill(points, points + WITNESS_RING_SIZE, -1); }
+};
+
+#define KILL 1
+#define LIVE 0
+void IntervalHyperBlock::mergerNotInCuda(vector<vector<vector<float>>> &trainingData, vector<HyperBlock> &hyperBlocks, AttributeColumns &pointsBrokenUp) {
+
+    int FIELD_LENGTH = hyperBlocks[0].minimums.size();
+
+    // the basic algorithm is this. we are going to maintain a terrorist watchlist.
+    // we find all points which are in our bounds for any attributes. when we are expanding our bounds to include
+    // new friends, we find all points which now might be in our new bound obviously, and add to watchlist. Then we just check the watchlist.
+    // for each block
+    vector<vector<HyperBlock>> inputBlocks(trainingData.size());
+
+    // dense global id for every point, used for the bitmaps in checkMergable. class c's points are [classOffsets[c], classOffsets[c + 1])
+    vector<int> classOffsets(trainingData.size() + 1, 0);
+    for (int classN = 0; classN < trainingData.size(); classN++) {
+        classOffsets[classN + 1] = classOffsets[classN] + trainingData[classN].size();
+    }
+
+    for (HyperBlock &h : hyperBlocks) {
+
+        // Ensure we have a pair for each attribute.
+        // Using resize is better than reserve here because we want to create FIELD_LENGTH elements,
+        // which we then update.
+        h.topBottomPairs.resize(FIELD_LENGTH);
+
+        // For each attribute (column), perform a binary search.
+        for (int attribute = 0; attribute < FIELD_LENGTH; attribute++) {
+
+            // Get the sorted vector of DataATTR for this attribute.
+            const vector<DataATTR>& columnPoints = pointsBrokenUp[attribute];
+
+            // Our target interval for this attribute (assuming each is stored as a one-element vector)
+            float lowerVal = h.minimums[attribute][0];
+            float upperVal = h.maximums[attribute][0];
+
+            // Binary search:
+            // lower_bound: first element whose value is not less than lowerVal.
+            auto lowIt = lower_bound(columnPoints.begin(), columnPoints.end(), lowerVal,
+                [](const DataATTR &d, float value) {
+                    return d.value < value;
+                });
+
+            // upper_bound: first element whose value is greater than upperVal.
+            auto highIt = upper_bound(columnPoints.begin(), columnPoints.end(), upperVal,
+                [](float value, const DataATTR &d) {
+                    return value < d.value;
+                });
+
+            // Determine indices:
+            // If lowIt reached the end, then no elements are ≥ lowerVal.
+            int lowIndex = (lowIt != columnPoints.end()) ? static_cast<int>(lowIt - columnPoints.begin()) : -1;
+
+            // For the topmost index, we want the last index in the range.
+            // upper_bound returns the first element greater than upperVal.
+            // If highIt equals columnPoints.begin(), then even the first element is greater than upperVal.
+            int highIndex = (highIt != columnPoints.begin()) ? static_cast<int>(highIt - columnPoints.begin()) - 1 : -1;
+
+            // Optionally, you might want to check whether these indices make sense.
+            // For example, if lowIndex == -1 or highIndex == -1 or if lowIndex > highIndex,
+            // it means no valid element was found for that attribute.
+            // You can handle that case as needed.
+
+            // Store the pair of indices (bottommost, topmost) for this attribute.
+            h.topBottomPairs[attribute] = make_pair(lowIndex, highIndex);
+        }
+
+        // add the HyperBlock to inputBlocks
+        inputBlocks[h.classNum].emplace_back(h);
+    }
+
+
+    // where every point sits in each sorted column. lets us check "is this point inside all the windows" without touching the values.
+    const int numPoints = classOffsets.back();
+    vector<int> columnRanks((size_t)FIELD_LENGTH * numPoints);
+    #pragma omp parallel for
+    for (int attribute = 0; attribute < FIELD_LENGTH; attribute++) {
+        for (int i = 0; i < pointsBrokenUp[attribute].size(); i++) {
+            const DataATTR &d = pointsBrokenUp[attribute][i];
+            columnRanks[(size_t)attribute * numPoints + d.id] = i;
+        }
+    }
+
+    // the classes don't touch each other's blocks, so each one is a task. the loops inside are taskloops so they go into the same pool.
+    #pragma omp parallel
+    #pragma omp single
+    for (int classN = 0; classN < inputBlocks.size(); classN++) {
+        #pragma omp task firstprivate(classN) shared(inputBlocks, pointsBrokenUp, classOffsets, columnRanks)
+        {
+            vector<HyperBlock>& blocks = inputBlocks[classN];
+
+            vector<char> mergableFlags(blocks.size(), 0);
+            vector<char> deleteFlags(blocks.size(), LIVE);
+
+            // each block's watchlist of wrong class points already inside it. computed once here, after that a merge only has to look at the widened slices.
+            // a block with anything on its watchlist can never pass a merge check, since the bounds only grow.
+            vector<vector<int>> watchlists(blocks.size());
+            vector<WitnessRing> witnessRings(blocks.size());
+            #pragma omp taskloop grainsize(8) default(shared)
+            for (int b = 0; b < blocks.size(); b++) {
+                watchlists[b] = buildWatchlist(pointsBrokenUp, blocks[b].topBottomPairs, classN, classOffsets, columnRanks);
+            }
+
+            for (int seed = 0; seed < (int)blocks.size() - 1; seed++) {
+
+                HyperBlock &seedBlock = blocks[seed];
+
+                // now we check if this block is mergeable to all the blocks after it.
+                // go through each seed block. now what we do is we are going to have to make that rearranging business happen just like in merger_cuda.
+                // the candidates only touch their own block and flags, whether anything merged comes back through the reduction.
+                bool merged = false;
+                #pragma omp taskloop grainsize(4) default(shared) reduction(||:merged)
+                for (int candidateBlock = seed + 1; candidateBlock < blocks.size(); candidateBlock++) {
+
+                    HyperBlock &candidate = blocks[candidateBlock];
+
+                    // already has a wrong class point inside, growing it won't get rid of that.
+                    if (!watchlists[candidateBlock].empty())
+                        continue;
+
+                    vector<pair<int, int>> combinedPairs(FIELD_LENGTH);
+                    for (int attribute = 0; attribute < FIELD_LENGTH; attribute++) {
+                        // new block has max of the two tops, and min of the two bottoms.
+                        combinedPairs[attribute] = {min(seedBlock.topBottomPairs[attribute].first,candidate.topBottomPairs[attribute].first),
+                                                    max(seedBlock.topBottomPairs[attribute].second, candidate.topBottomPairs[attribute].second)};
+                    }
+
+                    // whatever stopped this candidate last time is probably still inside, check those first.
+                    WitnessRing &ring = witnessRings[candidateBlock];
+                    bool blocked = false;
+                    for (int w = 0; w < WITNESS_RING_SIZE && !blocked; w++) {
+                        blocked = ring.points[w] >= 0 && insideWindows(ring.points[w], combinedPairs, numPoints, columnRanks);
+                    }
+                    if (blocked)
+                        continue;
+
+                    // check merging using set based checking instead of brute force checking the entire dataset. only the widened slices need looking at.
+                    int violator = findWidenedSliceViolator(pointsBrokenUp, candidate.topBottomPairs, combinedPairs, classN, classOffsets, columnRanks);
+                    if (violator >= 0) {
+                        ring.points[ring.head++ % WITNESS_RING_SIZE] = violator;
+                        continue;
+                    }
+                    mergableFlags[candidateBlock] = true;
+                    merged = true;
+
+                    vector<vector<float>> combinedMins(FIELD_LENGTH);
+                    vector<vector<float>> combinedMaxes(FIELD_LENGTH);
+
+                    for (int attribute = 0; attribute < FIELD_LENGTH; attribute++) {
+                        combinedMins[attribute].push_back(min(seedBlock.minimums[attribute][0], candidate.minimums[attribute][0]));
+                        combinedMaxes[attribute].push_back(max(seedBlock.maximums[attribute][0], candidate.maximums[attribute][0]));
+                    }
+                    // copy our new bounds into this block.
+                    candidate.minimums = combinedMins;
+                    candidate.maximums = combinedMaxes;
+
+                    candidate.topBottomPairs = combinedPairs;
+                }
+
+                // we can kill the seedblock if we are able to merge with any blocks.
+                if (merged)
+                    deleteFlags[seed] = KILL;
+
+                // after we have checked all our candidate blocks, we are going to rearrange the blocks like this.
+                // if we merged, we go to the back of the line. BUT, blocks which were earlier in the blocks go to the back, and ones which were later go to front.
+                // meaning that if block 1 merged, and block N merged, block 1 gets put in behind block N.
+
+                // Gather indices for blocks after 'seed'
+                vector<int> indices;
+                for (int i = seed + 1; i < blocks.size(); i++) {
+                    indices.push_back(i);
+                }
+
+                // Sort these indices based on mergableFlags criteria.
+                sort(indices.begin(), indices.end(), [&](int a, int b) {
+                    if (mergableFlags[a] != mergableFlags[b])
+                        return mergableFlags[a] < mergableFlags[b]; // false (0) first; i.e., non-mergeable remain at front.
+                    if (mergableFlags[a]) // if both are true, sort by index descending (later block comes first)
+                        return a > b;
+                    return a < b; // if both are false, keep the original order.
+                });
+
+                // Rebuild sorted arrays.
+                // First, copy blocks, mergableFlags, and deleteFlags from indices 0 to seed (unchanged)
+                vector<HyperBlock> sortedBlocks;
+                vector<char> sortedMergable;
+                vector<char> sortedDelete;
+                vector<vector<int>> sortedWatchlists;
+                vector<WitnessRing> sortedWitnessRings;
+                for (int i = 0; i <= seed; i++) {
+                    sortedBlocks.push_back(blocks[i]);
+                    sortedMergable.push_back(mergableFlags[i]);
+                    sortedDelete.push_back(deleteFlags[i]);
+                    sortedWatchlists.push_back(move(watchlists[i]));
+                    sortedWitnessRings.push_back(witnessRings[i]);
+                }
+            
+                // Then, append the sorted blocks for indices > seed.
+                for (int i : indices) {
+                    sortedBlocks.push_back(blocks[i]);
+                    sortedMergable.push_back(mergableFlags[i]);
+                    sortedDelete.push_back(deleteFlags[i]);
+                    sortedWatchlists.push_back(move(watchlists[i]));
+                    sortedWitnessRings.push_back(witnessRings[i]);
+                }
+
+                // Update the originals with the newly ordered data.
+                blocks = move(sortedBlocks);
+                mergableFlags = move(sortedMergable);
+                deleteFlags = move(sortedDelete);
+                watchlists = move(sortedWatchlists);
+                witnessRings = move(sortedWitnessRings);
+
+                // Reset all mergeable flags to 0.
+                fill(mergableFlags.begin(), mergableFlags.end(), 0);
+            }
+
+            // now once we are done with that merging business. we simply remove all the blocks which were marked KILL
+            blocks.erase(
+            remove_if(blocks.begin(), blocks.end(),
+                [&](const HyperBlock& block) {
+                    size_t index = &block - &blocks[0];
+                    return deleteFlags[index] == KILL;
+                }),
+                blocks.end()
+            );
+        }
+    }
+    // add all the blocks from each class back to hyperBlocks pointer
+    hyperBlocks.clear();
+    for (vector<HyperBlock>& blocks : inputBlocks) {
+        hyperBlocks.insert(hyperBlocks.end(), blocks.begin(), blocks.end());
+    }
+}
+
+// level N HBs implementation. we increase the level by simply finding envelope cases from each HB, and re running HB generation by using those envelope cases.
+// Lincoln's research showed that this increases accuracy, and we might be able to improve the coverage as well, using simplifications on top of level N
+vector<vector<vector<float>>> IntervalHyperBlock::increaseLevelOfTrainingSet(vector<HyperBlock> &hyperBlocks, vector<vector<vector<float>>> &inputTrainingData, int FIELD_LENGTH){
+
+    // set which is going to track the cases we are finding which are envelope cases each time
+    unordered_set<pair<int,int>, PairHash, PairEq> envelopeCases;
+
+    AttributeColumns pointsBrokenUp = separateByAttribute(inputTrainingData, FIELD_LENGTH);
+
+    // use the size of the training data to get the number of classes
+    vector<vector<vector<float>>> newTrainingData(inputTrainingData.size());
+
+    // Flag for any invalid HB
+    int invalid = 0;
+
+    // compute all the envelope cases in parallel. invalid flag is so that if one was invalid, we can just return {}
+    #pragma omp parallel for shared(envelopeCases, invalid)
+    for(int i = 0; i < (int)hyperBlocks.size(); ++i) {
+        auto &h = hyperBlocks[i];
+        auto hbCases = findHBEnvelopeCases(h, pointsBrokenUp);
+
+        if (hbCases.empty()) {
+            #pragma omp atomic
+            invalid++;
+        } else {
+            #pragma omp critical
+            envelopeCases.insert(hbCases.begin(), hbCases.end());
+        }
+    }
+
+    // After the parallel region, check the flag
+    if (invalid) {
+        // at least one HB was invalid. we return empty. this means that the user simplified the blocks most likely.
+        return {};
+    }
+
+    // now we just iterate through, and push back a copy into newTrainingData of each point we found in our envelope Cases
+    for (auto const& pr : envelopeCases)
+        newTrainingData[pr.first].push_back(inputTrainingData[pr.first][pr.second]);
+
+    return newTrainingData;
+}
+
+// stupid comparator overload thing so that we can search the columns nicely i guess.
+// only used in this findEnvelope cases. just lets us compare the dataAttrs and a float.
+// Place this above your function (e.g. in the same .cpp):
+struct DataAttrValueLess {
+    bool operator()(const DataATTR &d, float v) const { return d.value < v; }
+    bool operator()(float v, const DataATTR &d) const { return v < d.value; }
+};
+unordered_set<pair<int,int>, IntervalHyperBlock::PairHash, IntervalHyperBlock::PairEq> IntervalHyperBlock::findHBEnvelopeCases(HyperBlock &hb, AttributeColumns &dataByAttribute) {
+
+    unordered_set<pair<int,int>, PairHash, PairEq> envelopeCases;
+
+    int FIELD_LENGTH = dataByAttribute.size();
+
+    for (int attribute = 0; attribute < FIELD_LENGTH; attribute++) {
+        // inner loop which really is just going to run once unless we have a disjunction with multiple attributes
+        // finds the highest point of our class with HB value. takes all points which had that matching value
+        // THIS IS THE PART WHERE WE ARE FINDING ENVELOPE CASES!!!
+        // THEY GET ADDED TO THE SET, AND THEN WE RETURN THE SET FROM EACH HB!
+        for (int rule = 0; rule < hb.maximums[attribute].size(); ++rule) {
+            float upperB  = hb.maximums[attribute][rule];
+            float lowerB  = hb.minimums[attribute][rule];
+            int   myClass = hb.classNum;
+
+            bool found = false; // did we capture *any* boundary point?
+
+            // ── upper-bound: grab ONE point (the last/“highest” duplicate) ───────────
+            auto range_hi = std::equal_range(
+                dataByAttribute[attribute].begin(),
+                dataByAttribute[attribute].end(),
+                upperB,
+                DataAttrValueLess()
+            );
+            for (auto it = range_hi.second; it != range_hi.first; ) {   // walk backward
+                --it;
+                if (dataByAttribute.inClass(*it, myClass)) {
+                    envelopeCases.emplace(myClass, dataByAttribute.classIndex(*it));
+                    found = true;
+                    break; // take only the first match
+                }
+            }
+
+            // ── lower-bound: grab ONE point (the first/“lowest” duplicate) ───────────
+            auto range_lo = std::equal_range(
+                dataByAttribute[attribute].begin(),
+                dataByAttribute[attribute].end(),
+                lowerB,
+                DataAttrValueLess()
+            );
+            for (auto it = range_lo.first; it != range_lo.second; ++it) {
+                if (dataByAttribute.inClass(*it, myClass)) {
+                    envelopeCases.emplace(myClass, dataByAttribute.classIndex(*it));
+                    found = true;
+                    break;                             // take only the first match
+                }
+            }
+
+            if (!found) return {};                     // boundary missing ⇒ return empty so that we can show an error has happened.
+        }
+    }
+    return envelopeCases;
+}
+
+// takes in parameters for our original input data and blocks. also takes for new blocks. that is just so that we can return the new dataset
+// and the new blocks. since we need the updated datset each time as well as the updated blocks. so we pass in blank vectors of training data to populate, and then a blank vector of hyperblocks we want to populate.
+vector<vector<vector<float>>> IntervalHyperBlock::generateNextLevelHBs(vector<vector<vector<float>>> &trainingData, vector<HyperBlock> &inputBlocks, vector<HyperBlock> &nextLevelBlocks, vector<int> &bestAttributes, int FIELD_LENGTH, int COMMAND_LINE_ARGS_CLASS) {
+
+    vector<vector<vector<float>>> newDataset = increaseLevelOfTrainingSet(inputBlocks, trainingData, FIELD_LENGTH);
+
+    if (newDataset.size() == 0) {
+        cout << "ERROR: HYPERBLOCKS COULDN'T FIND ENVELOPE CASES!\n\tHBs CAN'T BE SIMPLIFIED BEFORE INCREASING LEVEL!" << endl;
+        return {};
+    }
+
+    // generate our new HBs with the new dataset and store them into our new HB vector
+    generateHBs(newDataset, nextLevelBlocks, bestAttributes, FIELD_LENGTH, COMMAND_LINE_ARGS_CLASS);
+
+    // now we find those points which are in our training set which we don't cover with level 2 blocks. we take those points, make them into HBs, and send them to the merging with these level 2 blocks. so that we get full coverage.
+    // each thread in openMP makes their own copies, and then we just aggregate these
+    for (int cls = 0; cls < static_cast<int>(trainingData.size()); ++cls) {
+
+        // the blocks grow after every class, so the boxes get built again each time.
+        const BlockBoxes boxes(nextLevelBlocks, FIELD_LENGTH);
+
+        // ─────────── parallel region ───────────
+        #pragma omp parallel
+        {
+            // thread-local containers (no races here)
+            vector<vector<vector<float>>> localDataThread(trainingData.size());
+            vector<HyperBlock>            localBlocksThread;
+            BlockBoxes::Scratch           scratch(boxes);
+
+            #pragma omp for schedule(static)
+            for (int p = 0; p < static_cast<int>(trainingData[cls].size()); ++p) {
+
+                // get the point, determine if it's in any HBs.
+                const auto &point = trainingData[cls][p];
+
+                // if it's in an HB, we are good, if not we make an HB out of it, and put it into the list. then we re run the merging with this point in it later.
+                bool inABlock = boxes.anyContaining(point.data(), scratch);
+
+                vector<vector<float>> mins(FIELD_LENGTH);
+                vector<vector<float>> maxes(FIELD_LENGTH);
+                for (int att = 0; att < FIELD_LENGTH; ++att) {
+                    mins[att].push_back(point[att]);
+                    maxes[att].push_back(point[att]);
+                }
+
+                if (!inABlock) {
+                    localBlocksThread.emplace_back(maxes, mins, cls);
+                    localDataThread[cls].emplace_back(point);
+                }
+            } // end for-p loop
+
+            // aggregate each thread’s contribution exactly once
+            #pragma omp critical
+            {
+                nextLevelBlocks.insert(end(nextLevelBlocks),make_move_iterator(begin(localBlocksThread)),make_move_iterator(end(localBlocksThread)));
+                for (size_t i = 0; i < localDataThread.size(); ++i) {
+                    newDataset[i].insert(end(newDataset[i]),   make_move_iterator(begin(localDataThread[i])),    make_move_iterator(end(localDataThread[i])));
+                }
+            }
+        } // end parallel region
+    }
+
+
+    // run the merging one more time, adding in the cases which we didn't cover. this means each level increase runs two merges. but the second one should be fast.
+    merger_cuda(newDataset, nextLevelBlocks, COMMAND_LINE_ARGS_CLASS);
+
+    return newDataset;
+}
\ No newline at end of file
@@ -12,11 +12,15 @@
 #include <ostream>
 #include <utility>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <numeric>
+#include <cstdint>
 #include <omp.h>
 #include "Interval.h"
 #include "DataAttr.h"
-#include "../hyperblock_generation/MergerHyperBlock.cuh"
+#include <limits>
+#include "../hyperblock_generation/ComputeBackend.h"
 
 #ifndef INTERVALHYPERBLOCK_H
 #define INTERVALHYPERBLOCK_H
@@ -42,17 +46,25 @@ class IntervalHyperBlock {
     };
 
 
-    static void pureBlockIntervalHyper(vector<vector<DataATTR>> &dataByAttribute, vector<vector<vector<float>>> &trainingData, vector<HyperBlock> &hyperBlocks, int COMMAND_LINE_ARGS_CLASS);
+    static void pureBlockIntervalHyper(AttributeColumns &dataByAttribute, vector<vector<vector<float>>> &trainingData, vector<HyperBlock> &hyperBlocks, int COMMAND_LINE_ARGS_CLASS);
 
-    static void intervalHyperWorker(vector<vector<DataATTR>> &attributeColumns, Interval &threadBestInterval, int threadID, int threadCount, atomic<int> &readyThreadsCount, char *currentPhase, unordered_set<pair<int, int>, PairHash, PairEq> &usedPoints, vector<char> &doneColumns, int COMMAND_LINE_ARGS_CLASS);
+    // what the supervisor and its workers share each round (barrier, column ranges, used point bitmap). lives in the .cpp.
+    struct RoundState;
 
-    static void intervalHyperSupervisor(vector<vector<vector<float>>> &realData, vector<vector<DataATTR>> &dataByAttribute, vector<HyperBlock> &hyperBlocks, int COMMAND_LINE_ARGS_CLASS);
+    static void intervalHyperWorker(AttributeColumns &attributeColumns, RoundState &state, int threadID, int COMMAND_LINE_ARGS_CLASS);
 
-    static Interval longestInterval(vector<DataATTR> &dataByAttribute, int attribute);
+    static void intervalHyperSupervisor(vector<vector<vector<float>>> &realData, AttributeColumns &dataByAttribute, vector<HyperBlock> &hyperBlocks, int COMMAND_LINE_ARGS_CLASS);
 
-    static void intervalHyper(vector<vector<vector<float>>> &realData, vector<vector<DataATTR>> &remainingData, vector<HyperBlock> &hyperBlocks);
+    // the tie groups of one sorted column, so the interval checks don't walk over equal values. lives in the .cpp.
+    struct ColumnTies;
 
-    static vector<vector<DataATTR>> separateByAttribute(const vector<vector<vector<float>>>& data, int FIELD_LENGTH);
+    static Interval longestInterval(AttributeColumns &dataByAttribute, const ColumnTies &ties, int attribute);
+
+    static void intervalHyper(vector<vector<vector<float>>> &realData, AttributeColumns &remainingData, vector<HyperBlock> &hyperBlocks);
+
+    static AttributeColumns separateByAttribute(const vector<vector<vector<float>>>& data, int FIELD_LENGTH);
+
+    static AttributeColumns separateByAttribute(const float *dataset, int numPoints, const int *classBorder, int numClasses, int FIELD_LENGTH);
 
     static void sortByColumn(vector<vector<float>>& classData, int colIndex);
 
@@ -60,13 +72,13 @@ class IntervalHyperBlock {
 
 	static void merger_cuda(const vector<vector<vector<float>>>& allData, vector<HyperBlock>& hyperBlocks, int COMMAND_LINE_ARGS_CLASS);
 
-    static void mergerNotInCuda(vector<vector<vector<float>>> &trainingData, vector<HyperBlock> &hyperBlocks, vector<vector<DataATTR>> &pointsBrokenUp);
+    static void mergerNotInCuda(vector<vector<vector<float>>> &trainingData, vector<HyperBlock> &hyperBlocks, AttributeColumns &pointsBrokenUp);
 
-    static bool checkMergable(vector<vector<DataATTR>> &dataByAttribute, HyperBlock &h);
+    static bool checkMergable(AttributeColumns &dataByAttribute, HyperBlock &h, const vector<int> &classOffsets);
 
     static vector<vector<vector<float>>> increaseLevelOfTrainingSet(vector<HyperBlock> &hyperBlocks, vector<vector<vector<float>>> &inputTrainingData, int FIELD_LENGTH);
 
-    static unordered_set<pair<int,int>, PairHash, PairEq> findHBEnvelopeCases(HyperBlock &hb, vector<vector<DataATTR>> &dataByAttribute);
+    static unordered_set<pair<int,int>, PairHash, PairEq> findHBEnvelopeCases(HyperBlock &hb, AttributeColumns &dataByAttribute);
 
     static vector<vector<vector<float>>> generateNextLevelHBs(vector<vector<vector<float>>> &trainingData, vector<HyperBlock> &inputBlocks, vector<HyperBlock> &nextLevelBlocks, vector<int> &bestAttributes, int FIELD_LENGTH, int COMMAND_LINE_ARGS_CLASS);
 
@@ -161,11 +161,15 @@ float Knn::euclideanDistancePoints(const std::vector<float>& point2, const std::
 *
 */
 int Knn::mergableKNN(const std::vector<float> &point, const std::vector<std::vector<std::vector<float>>> &trainingData, std::vector<HyperBlock> &hyperBlocks, int NUM_CLASSES) {
+    const AttributeColumns dataByAttribute = setupMergable(trainingData, hyperBlocks, point.size());
+    return mergableKNN(point, dataByAttribute, hyperBlocks);
+}
 
-    int FIELD_LENGTH = point.size();
+// the part of mergableKNN that doesn't depend on the point. it writes every block's topBottomPairs, so do it once before classifying from several threads.
+AttributeColumns Knn::setupMergable(const std::vector<std::vector<std::vector<float>>> &trainingData, std::vector<HyperBlock> &hyperBlocks, int FIELD_LENGTH) {
 
     // now we just take our training data, and first break it up by column exactly how we did in in the interval HB generation portion.
-    std::vector<std::vector<DataATTR>> dataByAttribute = IntervalHyperBlock::separateByAttribute(trainingData, FIELD_LENGTH);
+    AttributeColumns dataByAttribute = IntervalHyperBlock::separateByAttribute(trainingData, FIELD_LENGTH);
     for (HyperBlock &block : hyperBlocks) {
         // now we set up the top and bottom pairs for each block just to make sure that the bounds are made.
         block.topBottomPairs.resize(FIELD_LENGTH);
@@ -206,6 +210,14 @@ int Knn::mergableKNN(const std::vector<float> &point, const std::vector<std::vec
         }
     }
 
+    return dataByAttribute;
+}
+
+// only reads the blocks and the columns, so any number of threads can be in here at once.
+int Knn::mergableKNN(const std::vector<float> &point, const AttributeColumns &dataByAttribute, const std::vector<HyperBlock> &hyperBlocks) {
+
+    int FIELD_LENGTH = point.size();
+
     // tells us which index this point would be in in the sorted columns if inserted. we don't actually put it in though, that would change the data.
     std::vector<int> pointIndicesByColumn(FIELD_LENGTH, -1);
 
@@ -229,7 +241,7 @@ int Knn::mergableKNN(const std::vector<float> &point, const std::vector<std::vec
     int bestClass = -1;
     float bestAcc = 0.0f;
     int bestBlockSize = 0;
-    for (HyperBlock &block : hyperBlocks) {
+    for (const HyperBlock &block : hyperBlocks) {
 
         // now that our block is made, we can determine how many wrong points are going to fall in if we included this guy.
         // use the merge check to determine how "mergeable" this point is to each block, and we use the "most mergeable" class.
@@ -254,7 +266,7 @@ int Knn::mergableKNN(const std::vector<float> &point, const std::vector<std::vec
 //  enough to include the unclassified point whose per‑column index
 //  is given in insertIdx
 //  ───────────────────────────────────────────────────────────────
-float Knn::mergeCheck(std::vector<int> &insertIdx, HyperBlock &hb, std::vector<std::vector<DataATTR>> &columns) {
+float Knn::mergeCheck(const std::vector<int> &insertIdx, const HyperBlock &hb, const AttributeColumns &columns) {
     const int D = columns.size();
 
     // 1.  Make a local copy of bounds and enlarge with the new point.
@@ -280,11 +292,11 @@ float Knn::mergeCheck(std::vector<int> &insertIdx, HyperBlock &hb, std::vector<s
         const DataATTR& attr = col[idx];
 
         // Skip rows that already belong to the block’s class.
-        if (attr.classNum == hb.classNum) continue;
+        if (columns.inClass(attr, hb.classNum)) continue;
 
         // Check every other dimension quickly; bail on first failure.
         bool inside = true;
-        int row = attr.classIndex;
+        int row = columns.classIndex(attr);
         for (int d = 0; d < D; ++d) {
 
             if (d == pivot)
@@ -320,6 +332,13 @@ float Knn::mergeCheck(std::vector<int> &insertIdx, HyperBlock &hb, std::vector<s
 
 
 int Knn::bruteMergable(const std::vector<float>& point, const std::vector<std::vector<std::vector<float>>>& classifiedData, std::vector<HyperBlock>& hyperBlocks, int k, int NUM_CLASSES) {
+    const std::vector<std::pair<float, float>> classImpurityRange = setupBruteMergable(classifiedData, hyperBlocks, NUM_CLASSES);
+    return bruteMergable(point, classifiedData, hyperBlocks, classImpurityRange, NUM_CLASSES);
+}
+
+// the first phase of bruteMergable, the impurity range of every class. doesn't depend on the point, and runs its own parallel loop over the classes,
+// so buildConfusionMatrix does it once before its parallel loop instead of every point starting a parallel region inside it.
+std::vector<std::pair<float, float>> Knn::setupBruteMergable(const std::vector<std::vector<std::vector<float>>>& classifiedData, const std::vector<HyperBlock>& hyperBlocks, int NUM_CLASSES) {
     constexpr float EPSILON = 1e-6f;
     constexpr int NUM_SAMPLES = 300; // Sampling limit for each class
 
@@ -460,6 +479,20 @@ int Knn::bruteMergable(const std::vector<float>& point, const std::vector<std::v
         }
     }
 
+    return classImpurityRange;
+}
+
+// only reads the blocks and the data, so any number of threads can be in here at once.
+int Knn::bruteMergable(const std::vector<float>& point, const std::vector<std::vector<std::vector<float>>>& classifiedData, const std::vector<HyperBlock>& hyperBlocks, const std::vector<std::pair<float, float>>& classImpurityRange, int NUM_CLASSES) {
+    constexpr float EPSILON = 1e-6f;
+
+    int FIELD_LENGTH = hyperBlocks[0].maximums.size();
+
+    std::vector<std::vector<size_t>> blocksByClass(NUM_CLASSES);
+    for (size_t i = 0; i < hyperBlocks.size(); i++) {
+        blocksByClass[hyperBlocks[i].classNum].push_back(i);
+    }
+
     // Second phase: classify the single point
     std::vector<float> bestImpurities(NUM_CLASSES, std::numeric_limits<float>::max());
     for (int targetClass = 0; targetClass < NUM_CLASSES; ++targetClass) {
@@ -499,30 +532,32 @@ int Knn::bruteMergable(const std::vector<float>& point, const std::vector<std::v
             if (!anyChange) continue;
 
             int rightCls = 0, wrongCls = 0;
-            for (auto& cp : allClassifiedPoints) {
-                bool inBlk = true;
-                for (int a = 0; a < FIELD_LENGTH; ++a) {
-                    if (cp.point[a] < block.minimums[a][0] - EPSILON ||
-                        cp.point[a] > block.maximums[a][0] + EPSILON) {
-                        inBlk = false;
-                        break;
+            for (int cls = 0; cls < NUM_CLASSES; ++cls) {
+                for (const auto& cpPoint : classifiedData[cls]) {
+                    bool inBlk = true;
+                    for (int a = 0; a < FIELD_LENGTH; ++a) {
+                        if (cpPoint[a] < block.minimums[a][0] - EPSILON ||
+                            cpPoint[a] > block.maximums[a][0] + EPSILON) {
+                            inBlk = false;
+                            break;
+                        }
                     }
-                }
-                if (inBlk) continue;
-
-                bool inExp = false;
-                for (int a = 0; a < FIELD_LENGTH; ++a) {
-                    if (useExp[a] &&
-                        cp.point[a] >= expansion[a].first  - EPSILON &&
-                        cp.point[a] <= expansion[a].second + EPSILON) {
-                        inExp = true;
-                        break;
+                    if (inBlk) continue;
+
+                    bool inExp = false;
+                    for (int a = 0; a < FIELD_LENGTH; ++a) {
+                        if (useExp[a] &&
+                            cpPoint[a] >= expansion[a].first  - EPSILON &&
+                            cpPoint[a] <= expansion[a].second + EPSILON) {
+                            inExp = true;
+                            break;
+                        }
                     }
-                }
-                if (!inExp) continue;
+                    if (!inExp) continue;
 
-                if (cp.classLabel == targetClass) ++rightCls;
-                else ++wrongCls;
+                    if (cls == targetClass) ++rightCls;
+                    else ++wrongCls;
+                }
             }
 
             float imp = 1.0f;
@@ -625,6 +660,16 @@ std::vector<float> Knn::computeStdDeviations(const std::vector<std::vector<std::
 
 // this needs to get reset to false every time we bring in a new dataset
 bool Knn::deviationsComputed = false;
+std::vector<float> Knn::deviations;
+
+// only computes them once, until deviationsComputed gets reset. buildConfusionMatrix calls this before its parallel loop, so the threads in thresholdKNN only ever read them.
+void Knn::setupDeviations(const std::vector<std::vector<std::vector<float>>> &trainData) {
+    if (!deviationsComputed) {
+        deviations = computeStdDeviations(trainData);
+        deviationsComputed = true;
+    }
+}
+
 int Knn::thresholdKNN(const std::vector<float> &point, const std::vector<std::vector<std::vector<float>>>& classifiedData, int NUM_CLASSES, int k, float threshold) {
 
     // Number of attributes in the point
@@ -632,11 +677,7 @@ int Knn::thresholdKNN(const std::vector<float> &point, const std::vector<std::ve
 
 
     // Only compute once, on the first call
-    static std::vector<float> deviations;
-    if (!deviationsComputed) {
-        deviations = computeStdDeviations(classifiedData);
-        deviationsComputed = true;
-    }
+    setupDeviations(classifiedData);
 
     // Count total number of training points
     int totalTrainingPoints = 0;
@@ -33,17 +33,23 @@ class Knn {
     static bool isInside(const std::vector<float>& point, const std::vector<std::vector<float>>& fMins, const std::vector<std::vector<float>>& fMaxes);
 
     static int bruteMergable(const std::vector<float> &point, const std::vector<std::vector<std::vector<float>>> &classifiedData, std::vector<HyperBlock>& hyperBlocks,int k,int NUM_CLASSES);
+    static std::vector<std::pair<float, float>> setupBruteMergable(const std::vector<std::vector<std::vector<float>>> &classifiedData, const std::vector<HyperBlock>& hyperBlocks, int NUM_CLASSES);
+    static int bruteMergable(const std::vector<float> &point, const std::vector<std::vector<std::vector<float>>> &classifiedData, const std::vector<HyperBlock>& hyperBlocks, const std::vector<std::pair<float, float>> &classImpurityRange, int NUM_CLASSES);
 
     static int mergableKNN(const std::vector<float> &point, const std::vector<std::vector<std::vector<float>>> &trainingData, std::vector<HyperBlock> &hyperBlocks, int NUM_CLASSES);
+    static AttributeColumns setupMergable(const std::vector<std::vector<std::vector<float>>> &trainingData, std::vector<HyperBlock> &hyperBlocks, int FIELD_LENGTH);
+    static int mergableKNN(const std::vector<float> &point, const AttributeColumns &dataByAttribute, const std::vector<HyperBlock> &hyperBlocks);
 
-    static float mergeCheck(std::vector<int> &insertIdx, HyperBlock &h, std::vector<std::vector<DataATTR>> &dataByAttribute);
+    static float mergeCheck(const std::vector<int> &insertIdx, const HyperBlock &h, const AttributeColumns &dataByAttribute);
 
     static int pureKnn(const std::vector<float> &point, const std::vector<std::vector<std::vector<float>>> &classifiedData, const int NUM_CLASSES, const int k);
 
     static std::vector<float> losslessDistance(const std::vector<float> &seedPoint, const std::vector<float> &trainPoint);
 
     static bool deviationsComputed;
+    static std::vector<float> deviations;
     static std::vector<float> computeStdDeviations(const std::vector<std::vector<std::vector<float>>> &trainData);
+    static void setupDeviations(const std::vector<std::vector<std::vector<float>>> &trainData);
 
     static int thresholdKNN(const std::vector<float> &point, const std::vector<std::vector<std::vector<float>>> &classifiedData, int NUM_CLASSES, int k, float threshold);
 };
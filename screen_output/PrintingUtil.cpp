@@ -42,6 +42,7 @@ void PrintingUtil::displayMainMenu() {
     cout << "5. Export regular HBs.\n";
     cout << "6. Generate HBs.\n";
     cout << "7. Simplify HBs.\n";
+    cout << "21. Simplify HBs, trying several attribute removal orders per block.\n";
     cout << "8. Test HBs.\n";
     cout << "9. Test 1-1 HBs.\n";
     cout << "10. K-Fold Cross Validation.\n";
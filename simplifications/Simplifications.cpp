@@ -0,0 +1,306 @@
+//
+// Created by Austin Snyder on 3/20/2025.
+//
+#include "Simplifications.h"
+int Simplifications::REMOVAL_COUNT = 0;
+
+// the blocks in the flattenMinsMaxesForRUB encoding with the edges as ints, and the dataset row major. what the removeUselessBlocks passes read.
+struct RUBArrays {
+    vector<float> blockMins;
+    vector<float> blockMaxes;
+    vector<int> blockEdges;
+    vector<float> dataPointsArray;
+
+    RUBArrays(vector<vector<vector<float>>> &data, vector<HyperBlock>& hyper_blocks, int FIELD_LENGTH) {
+        vector<vector<float>> minMaxResult = DataUtil::flattenMinsMaxesForRUB(hyper_blocks, FIELD_LENGTH);
+        vector<vector<float>> flattenedData =  DataUtil::flattenDataset(data);
+
+        blockMins = move(minMaxResult[0]);
+        blockMaxes = move(minMaxResult[1]);
+
+        // cast result [2] to ints, since this is the block edges. the array which tells us where each block starts and ends (as indexes).
+        const vector<float> &edgesAsFloats = minMaxResult[2];
+        blockEdges.resize(edgesAsFloats.size());
+        transform(edgesAsFloats.begin(), edgesAsFloats.end(), blockEdges.begin(),
+                  [](float val) -> int { return static_cast<int>(val); });
+
+        dataPointsArray = move(flattenedData[0]);
+    }
+};
+
+/**
+ * Runs our kernel functions (through the compute backend) which remove useless blocks / Remove Redundant Blocks (R2A)
+ *
+ * Details are discussed further in "Fully Explainable Classification Models Using Hyperblocks", 2025. Ryan Gallagher, Austin Snyder, Boris Kovalerchuk
+ */
+void Simplifications::removeUselessBlocks(vector<vector<vector<float>>> &data, vector<HyperBlock>& hyper_blocks) {
+    /*
+     * The algorithm to remove useless blocks does basically this.
+     *     - take one particular point in our dataset. Find the first HB that it fits into.
+     *     - then, once everyone has found their first choice, we sum up the count of which HBs have how many points
+     *     - then, we run it again, this time starting from the block which each point chose. We pick a new HB instead, if we find one which our point falls into, and which has a higher amount of points in it than our current
+     *     - this is not a perfect way of doing it, but at least allows us to find the "most general blocks" based on the count of how many points are in each. This way we can then just delete whichever blocks we find with no *UNIQUE* points in them.
+     *     * notice how we are putting all data in, and all blocks together. this allows us to find errors as well. we may find that a block is letting in wrong class points this way.
+     */
+    int FIELD_LENGTH = data[0][0].size();
+    RUBArrays arrays(data, hyper_blocks, FIELD_LENGTH);
+
+    const int numPoints = arrays.dataPointsArray.size() / FIELD_LENGTH;
+    const int numBlocks = hyper_blocks.size();                    // Number of hyperblocks.
+    vector<int> numPointsInBlocks(numBlocks, 0);              // Count of points in each hyperblock.
+
+    // ASSIGN -> SUM -> FIND BETTER -> SUM, on the GPU or CPU depending on the backend.
+    ComputeBackend::get().countPointsPerBlock(arrays.dataPointsArray.data(), FIELD_LENGTH, numPoints, arrays.blockMins.data(), arrays.blockMaxes.data(), arrays.blockMins.size(), arrays.blockEdges.data(), numBlocks, numPointsInBlocks.data());
+
+    // Remove blocks with less than our count of unique points
+    // unique points refers to the amount of points which are classified uniquely by this particular block.
+    for (int i = numPointsInBlocks.size() - 1; i >= 0; i--) {
+        if (numPointsInBlocks[i] <= REMOVAL_COUNT)
+            hyper_blocks.erase(hyper_blocks.begin() + i);
+    }
+}
+
+/**
+ * Same as above, but the counts come from a BlockCoverage that was built over these blocks (and has seen every removal since),
+ * so only the points touched by the blocks we delete get redone. runSimplifications uses this to avoid recounting every round.
+ */
+void Simplifications::removeUselessBlocks(vector<HyperBlock>& hyper_blocks, BlockCoverage &coverage) {
+    vector<int> uselessBlocks;
+    for (int i = 0; i < coverage.numBlocks(); i++) {
+        if (coverage.pointsIn(i) <= REMOVAL_COUNT)
+            uselessBlocks.push_back(i);
+    }
+
+    coverage.removeBlocks(uselessBlocks);
+    for (int i = uselessBlocks.size() - 1; i >= 0; i--)
+        hyper_blocks.erase(hyper_blocks.begin() + uselessBlocks[i]);
+}
+
+/**
+ * Attempts to remove redundant attributes from hyperblocks.
+ *
+ * This can be done if the attribute is not needed for classification,
+ * for example if everything is seperable by x1, then we don't need to keep x2.
+ *
+ * Details are discussed further in "Fully Explainable Classification Models Using Hyperblocks", 2025. Ryan Gallagher, Austin Snyder, Boris Kovalerchuk
+ * @param hyper_blocks
+ * @param data
+ * @param attributeOrderings
+ * @param searchRemovalOrders try several attribute removal orders per block and keep whichever takes out the most clauses, instead of only attributeOrderings
+ */
+void Simplifications::removeUselessAttrNoDisjunction(vector<HyperBlock>& hyper_blocks, vector<vector<vector<float>>>& data, vector<vector<int>>& attributeOrderings, bool searchRemovalOrders) {
+    const int FIELD_LENGTH = data[0][0].size();
+
+    // Prepare host data by flattening your data structures.
+    auto fMinMaxResult =  DataUtil::flatMinMaxNoEncode(hyper_blocks, FIELD_LENGTH);
+    auto fDataResult =  DataUtil::flattenDataset(data);
+
+    // Build host arrays from the flattened results:
+    vector<float> mins = fMinMaxResult[0];
+    vector<float> maxes = fMinMaxResult[1];
+
+    const int numBlocks = static_cast<int>(hyper_blocks.size());
+
+    // flatMinMaxNoEncode gives back mins, maxes, classes.
+    vector<int> blockClasses(fMinMaxResult[2].size());
+    for (size_t i = 0; i < fMinMaxResult[2].size(); i++) {
+        blockClasses[i] = static_cast<int>(fMinMaxResult[2][i]);
+    }
+
+    // Prepare the dataset.
+    int numPoints = static_cast<int>(fDataResult[0].size() / FIELD_LENGTH);
+
+    vector<int> classBorder(fDataResult[1].size());
+    for (size_t i = 0; i < fDataResult[1].size(); i++) {
+        classBorder[i] = static_cast<int>(fDataResult[1][i]);
+    }
+    int numClasses = static_cast<int>(data.size());
+
+    std::vector<int> attributeOrderingsFlattened(attributeOrderings.size() * FIELD_LENGTH, 0);
+    for (int i = 0; i < attributeOrderings.size(); i++) {
+        copy(attributeOrderings[i].begin(), attributeOrderings[i].end(),
+            attributeOrderingsFlattened.begin() + i * FIELD_LENGTH);
+    }
+
+    if (searchRemovalOrders) {
+        // the search takes the disjunctive layout, so every attribute becomes one interval with its count of 1 in front. still only the first interval, same as below.
+        const int stride = 2 * FIELD_LENGTH;
+        vector<float> searchMins((size_t)numBlocks * stride, 1.0f);
+        vector<float> searchMaxes((size_t)numBlocks * stride, 1.0f);
+        vector<int> blockEdges(numBlocks);
+        vector<int> intervalCounts((size_t)numBlocks * FIELD_LENGTH, 1);
+        vector<char> attrRemoveFlags((size_t)numBlocks * FIELD_LENGTH, 0);
+        for (int b = 0; b < numBlocks; b++) {
+            blockEdges[b] = b * stride;
+            for (int a = 0; a < FIELD_LENGTH; a++) {
+                searchMins[(size_t)b * stride + 2 * a + 1] = mins[(size_t)b * FIELD_LENGTH + a];
+                searchMaxes[(size_t)b * stride + 2 * a + 1] = maxes[(size_t)b * FIELD_LENGTH + a];
+            }
+        }
+
+        // all bookkeeping over each block's escape sets, so it stays on the host whatever the backend is.
+        searchRemovalOrderingsCPU(searchMins.data(), searchMaxes.data(), intervalCounts.data(), blockEdges.data(), numBlocks, blockClasses.data(), attrRemoveFlags.data(), FIELD_LENGTH, fDataResult[0].data(), numPoints, classBorder.data(), numClasses, attributeOrderingsFlattened.data());
+
+        for (int b = 0; b < numBlocks; b++) {
+            for (int a = 0; a < FIELD_LENGTH; a++) {
+                mins[(size_t)b * FIELD_LENGTH + a] = searchMins[(size_t)b * stride + 2 * a + 1];
+                maxes[(size_t)b * FIELD_LENGTH + a] = searchMaxes[(size_t)b * stride + 2 * a + 1];
+            }
+        }
+    }
+    else {
+        // the order each class tests a point's attributes in. whichever ones throw out the most wrong class points go first.
+        std::vector<int> checkOrdersFlattened(numClasses * FIELD_LENGTH, 0);
+        for (int i = 0; i < numClasses; i++) {
+            vector<int> checkOrder = HyperBlock::rejectionOrder(hyper_blocks, data, i);
+            copy(checkOrder.begin(), checkOrder.end(), checkOrdersFlattened.begin() + i * FIELD_LENGTH);
+        }
+
+        // the CUDA backend transposes the dataset itself, so we just hand it the row major one.
+        ComputeBackend::get().removeUselessAttributesNoDisjunctions(mins.data(), maxes.data(), numBlocks, FIELD_LENGTH, blockClasses.data(), fDataResult[0].data(), numPoints, classBorder.data(), numClasses, attributeOrderingsFlattened.data(), checkOrdersFlattened.data());
+    }
+
+    // Go through the blocks, copy data back in.
+    int index = 0;
+    for(int i = 0; i < numBlocks; i++) {
+        auto& hb = hyper_blocks[i];
+        // Go through the attributes
+        for(int attr = 0; attr < FIELD_LENGTH; attr++) {
+            hb.minimums[attr][0] = mins[index];
+            hb.maximums[attr][0] = maxes[index];
+            index++;
+        }
+    }
+}
+
+/**
+ * Attempts to remove redundant attributes from hyperblocks.
+ *
+ * This can be done if the attribute is not needed for classification,
+ * for example if everything is seperable by x1, then we don't need to keep x2.
+ *
+ * Details are discussed further in "Fully Explainable Classification Models Using Hyperblocks", 2025. Ryan Gallagher, Austin Snyder, Boris Kovalerchuk
+ * @param hyper_blocks
+ * @param data
+ * @param attributeOrderings
+ * @param searchRemovalOrders try several attribute removal orders per block and keep whichever takes out the most clauses, instead of only attributeOrderings
+ */
+void Simplifications::removeUselessAttr(std::vector<HyperBlock>& hyper_blocks, std::vector<std::vector<std::vector<float>>>& data, std::vector<std::vector<int>>& attributeOrderings, bool searchRemovalOrders) {
+    int FIELD_LENGTH = data[0][0].size();
+
+    // Prepare host data by flattening your data structures.
+    auto fMinMaxResult =  DataUtil::flattenMinsMaxesForRUB(hyper_blocks, FIELD_LENGTH);
+    auto fDataResult =  DataUtil::flattenDataset(data);
+
+    // Build host arrays from the flattened results:
+    std::vector<float> mins = fMinMaxResult[0];
+    std::vector<float> maxes = fMinMaxResult[1];
+    int minMaxLen = static_cast<int>(mins.size());
+
+    std::vector<int> blockEdges(fMinMaxResult[2].size());
+    for (size_t i = 0; i < fMinMaxResult[2].size(); i++) {
+        blockEdges[i] = static_cast<int>(fMinMaxResult[2][i]);
+    }
+    int numBlocks = static_cast<int>(hyper_blocks.size());
+
+    std::vector<int> blockClasses(fMinMaxResult[3].size());
+    for (size_t i = 0; i < fMinMaxResult[3].size(); i++) {
+        blockClasses[i] = static_cast<int>(fMinMaxResult[3][i]);
+    }
+
+    std::vector<int> intervalCounts(fMinMaxResult[4].size());
+    for (size_t i = 0; i < fMinMaxResult[4].size(); i++) {
+        intervalCounts[i] = static_cast<int>(fMinMaxResult[4][i]);
+    }
+
+    // Create flags array (initialize to 0).
+    std::vector<char> attrRemoveFlags(hyper_blocks.size() * FIELD_LENGTH, 0);
+
+    // Prepare the dataset.
+    std::vector<float> dataset = fDataResult[0];
+    int numPoints = static_cast<int>(dataset.size() / FIELD_LENGTH);
+
+    std::vector<int> classBorder(fDataResult[1].size());
+    for (size_t i = 0; i < fDataResult[1].size(); i++) {
+        classBorder[i] = static_cast<int>(fDataResult[1][i]);
+    }
+    int numClasses = static_cast<int>(data.size());
+
+    std::vector<int> attributeOrderingsFlattened(attributeOrderings.size() * FIELD_LENGTH, 0);
+    for (int i = 0; i < attributeOrderings.size(); i++) {
+        copy(attributeOrderings[i].begin(), attributeOrderings[i].end(),
+            attributeOrderingsFlattened.begin() + i * FIELD_LENGTH);
+    }
+
+    // the order each class tests a point's attributes in. whichever ones throw out the most wrong class points go first.
+    std::vector<int> checkOrdersFlattened(numClasses * FIELD_LENGTH, 0);
+    for (int i = 0; i < numClasses; i++) {
+        vector<int> checkOrder = HyperBlock::rejectionOrder(hyper_blocks, data, i);
+        copy(checkOrder.begin(), checkOrder.end(), checkOrdersFlattened.begin() + i * FIELD_LENGTH);
+    }
+
+    // the order search is all bookkeeping over each block's escape sets, so it stays on the host whatever the backend is.
+    if (searchRemovalOrders)
+        searchRemovalOrderingsCPU(mins.data(), maxes.data(), intervalCounts.data(), blockEdges.data(), numBlocks, blockClasses.data(), attrRemoveFlags.data(), FIELD_LENGTH, dataset.data(), numPoints, classBorder.data(), numClasses, attributeOrderingsFlattened.data());
+    else
+        ComputeBackend::get().removeUselessAttributes(mins.data(), maxes.data(), intervalCounts.data(), minMaxLen, blockEdges.data(), numBlocks, blockClasses.data(), attrRemoveFlags.data(), FIELD_LENGTH, dataset.data(), numPoints, classBorder.data(), numClasses, attributeOrderingsFlattened.data(), checkOrdersFlattened.data());
+
+    // Update the hyper_blocks based on the flags.
+    for (size_t hb = 0; hb < hyper_blocks.size(); hb++) {
+        HyperBlock &block = hyper_blocks[hb];
+        // For each attribute in the block (assumes FIELD_LENGTH attributes per block)
+        for (int attr = 0; attr < FIELD_LENGTH; attr++) {
+            int index = hb * FIELD_LENGTH + attr;
+            if (attrRemoveFlags[index] == 1) {
+                // Remove the attribute intervals and reset to default values.
+                if (attr < block.minimums.size() && attr < block.maximums.size()) {
+                    block.minimums[attr].clear();
+                    block.maximums[attr].clear();
+                    block.minimums[attr].push_back(0.0f);
+                    block.maximums[attr].push_back(1.0f);
+                }
+            }
+        }
+    }
+}
+
+vector<int> Simplifications::runSimplifications(vector<HyperBlock> &hyperBlocks, vector<vector<vector<float>>> &trainData, vector<vector<int>> &bestAttributeOrderings, bool searchRemovalOrders){
+    int FIELD_LENGTH = trainData[0][0].size();
+    int runCount = 0;
+    int totalClauses = 0;
+    int updatedClauses = 0;
+
+    Simplifications::removeUselessAttr(hyperBlocks, trainData, bestAttributeOrderings, searchRemovalOrders);
+
+    // the blocks don't change shape from here on, they only get deleted. so flatten once and keep which blocks each point is in,
+    // every round after the first only redoes the points that were in the blocks we just deleted.
+    BlockCoverage coverage;
+    {
+        RUBArrays arrays(trainData, hyperBlocks, FIELD_LENGTH);
+        coverage.build(arrays.dataPointsArray.data(), FIELD_LENGTH, arrays.dataPointsArray.size() / FIELD_LENGTH, arrays.blockMins.data(), arrays.blockMaxes.data(), arrays.blockEdges.data(), hyperBlocks.size());
+    }
+
+    do{
+        // set our count of what we have to start
+        totalClauses = updatedClauses;
+        runCount++; // counter so we can show how many iterations this took.
+
+        // simplification functions
+        Simplifications::removeUselessBlocks(hyperBlocks, coverage);
+
+        // count how many we have after simplifications.
+        updatedClauses = 0;
+        for(HyperBlock &hyperBlock : hyperBlocks) {
+            for(int i = 0; i < FIELD_LENGTH; i++){
+                if (hyperBlock.minimums[i][0] == 0 && hyperBlock.maximums[i][0] == 1.0f){
+                    continue;
+                }
+                else
+                    updatedClauses += hyperBlock.minimums[i].size();
+            }
+        }
+
+    // iteratively call the simplifications until we don't remove any more clauses.
+    } while(updatedClauses != totalClauses);
+    return { runCount, totalClauses };
+}
@@ -2,9 +2,9 @@
 
 #pragma once
 #include "../hyperblock/HyperBlock.h"
-#include <cuda_runtime.h>
 #include "../data_utilities/DataUtil.h"
-#include "../hyperblock_generation/MergerHyperBlock.cuh"
+#include "../hyperblock_generation/ComputeBackend.h"
+#include "../hyperblock_generation/MergerHyperBlockCPU.h"
 #include <algorithm>
 #include <vector>
 
@@ -14,9 +14,10 @@ class Simplifications {
     public:
         static int REMOVAL_COUNT;
         static void removeUselessBlocks(vector<vector<vector<float>>> &data, vector<HyperBlock>& hyper_blocks);
-        static vector<int> runSimplifications(vector<HyperBlock> &hyperBlocks, vector<vector<vector<float>>> &trainData, vector<vector<int>> &bestAttributeOrdering);
-        static void removeUselessAttr(vector<HyperBlock> &hyper_blocks, vector<vector<vector<float>>> &data, vector<vector<int>> &attributeOrderings);
-        static void removeUselessAttrNoDisjunction(std::vector<HyperBlock>& hyper_blocks, std::vector<std::vector<std::vector<float>>>& data, std::vector<std::vector<int>>& attributeOrderings);
+        static void removeUselessBlocks(vector<HyperBlock>& hyper_blocks, BlockCoverage &coverage);
+        static vector<int> runSimplifications(vector<HyperBlock> &hyperBlocks, vector<vector<vector<float>>> &trainData, vector<vector<int>> &bestAttributeOrdering, bool searchRemovalOrders = false);
+        static void removeUselessAttr(vector<HyperBlock> &hyper_blocks, vector<vector<vector<float>>> &data, vector<vector<int>> &attributeOrderings, bool searchRemovalOrders = false);
+        static void removeUselessAttrNoDisjunction(std::vector<HyperBlock>& hyper_blocks, std::vector<std::vector<std::vector<float>>>& data, std::vector<std::vector<int>>& attributeOrderings, bool searchRemovalOrders = false);
 };
 
 